@@ -0,0 +1,85 @@
+#version 330 core
+
+#define render geometry
+
+layout(location = 0) in vec3 vertexPos;
+layout(location = 1) in vec2 vertexUV;
+layout(location = 2) in vec3 normal;
+
+layout(location = 3) in mat4 T_M;
+layout(location = 7) in mat3 T_Normal;
+layout(location = 10) in mat4 T_MVP;
+
+// Three texels per building piece: The four corners of the piece (from a top-down view), the lower and upper height of
+// the piece and the (bit casted) cell ID and highlight status.
+uniform samplerBuffer instanceData;
+
+// The highlight status of each cell of the chunk, indexed by the cell ID within the chunk (i.e. the lower 10 bits of the
+// cell ID).
+uniform usamplerBuffer lookupData;
+
+uniform int pick;
+
+uniform vec3 kA;
+out vec3 ambient;
+out float e;
+
+out vec2 uv;
+out vec3 world_normal;
+out vec3 world_pos;
+
+const vec3 highlightColors[3] = vec3[3](
+	vec3(0.0, 0.0, 0.0),	// No highlighting
+	vec3(0.0, 0.1, 0.0),	// Planned for construction
+	vec3(0.1, 0.0, 0.0)		// Planned for destruction
+);
+
+// A small offset along the normal used for transforming the normal by the same deformation as the vertex position.
+const float normalEpsilon = 0.1;
+
+vec2 interpolateBilinear(vec2 point, vec2 frontLeft, vec2 frontRight, vec2 backLeft, vec2 backRight) {
+	return (1 - point.x) * (1 - point.y) * frontLeft
+		+ point.x * (1 - point.y) * frontRight
+		+ (1 - point.x) * point.y * backLeft
+		+ point.x * point.y * backRight;
+}
+
+void main() {
+	vec4 frontCorners = texelFetch(instanceData, 3 * gl_InstanceID);
+	vec4 backCorners = texelFetch(instanceData, 3 * gl_InstanceID + 1);
+	vec4 heightsAndCell = texelFetch(instanceData, 3 * gl_InstanceID + 2);
+
+	// Deform the piece from object coordinates to the quad spanned by its corners.
+	float deltaHeight = heightsAndCell.y - heightsAndCell.x;
+	vec2 pos = interpolateBilinear(vertexPos.xz, frontCorners.xy, frontCorners.zw, backCorners.xy, backCorners.zw);
+	vec3 piecePos = vec3(pos.x, vertexPos.y * deltaHeight + heightsAndCell.x, pos.y);
+
+	vec2 normalPos = vertexPos.xz + normalEpsilon * normal.xz;
+	vec2 normalDir = interpolateBilinear(normalPos, frontCorners.xy, frontCorners.zw, backCorners.xy, backCorners.zw) - pos;
+	vec3 pieceNormal = normalize(vec3(normalDir.x, normalEpsilon * normal.y * deltaHeight, normalDir.y));
+
+	gl_Position = T_MVP * vec4(piecePos, 1);
+
+	uv = vertexUV;
+
+	// output position and normal in world space for lighting calculations in
+	// the fragment shader
+	world_pos = (T_M * vec4(piecePos, 1)).xyz;
+	world_normal = normalize(T_Normal * pieceNormal);
+
+	int cellID = int(floatBitsToUint(heightsAndCell.z));
+	int highlightID = max(int(floatBitsToUint(heightsAndCell.w)), int(texelFetch(lookupData, cellID & 0x3ff).r));
+
+	ambient = kA;
+	e = 0;
+
+	if ((pick & 0xffffff) == (cellID & 0xffffff)) {
+		ambient += vec3(0.1);
+		e = 2;
+	}
+
+	if (highlightID != 0) {
+		ambient += highlightColors[highlightID];
+		e = 2;
+	}
+}
@@ -0,0 +1,24 @@
+#version 330 core
+layout(location = 0) in vec3 vertexPos;
+
+layout(location = 10) in mat4 T_MVP;
+
+// See building.vert for the layout of the instance data.
+uniform samplerBuffer instanceData;
+
+vec2 interpolateBilinear(vec2 point, vec2 frontLeft, vec2 frontRight, vec2 backLeft, vec2 backRight) {
+	return (1 - point.x) * (1 - point.y) * frontLeft
+		+ point.x * (1 - point.y) * frontRight
+		+ (1 - point.x) * point.y * backLeft
+		+ point.x * point.y * backRight;
+}
+
+void main() {
+	vec4 frontCorners = texelFetch(instanceData, 3 * gl_InstanceID);
+	vec4 backCorners = texelFetch(instanceData, 3 * gl_InstanceID + 1);
+	vec4 heightsAndCell = texelFetch(instanceData, 3 * gl_InstanceID + 2);
+
+	float deltaHeight = heightsAndCell.y - heightsAndCell.x;
+	vec2 pos = interpolateBilinear(vertexPos.xz, frontCorners.xy, frontCorners.zw, backCorners.xy, backCorners.zw);
+	gl_Position = T_MVP * vec4(pos.x, vertexPos.y * deltaHeight + heightsAndCell.x, pos.y, 1);
+}
@@ -12,6 +12,11 @@ layout(location = 10) in mat4 T_MVP;
 
 layout(location = 14) in uvec2 cellIdAndType;
 
+// The highlight status of each cell of the chunk, indexed by the cell ID within the chunk (i.e. the lower 10 bits of the
+// cell ID).
+uniform usamplerBuffer lookupData;
+uniform bool hasLookupData;
+
 uniform int pick;
 
 uniform vec3 kA;
@@ -39,7 +44,7 @@ void main() {
 	world_normal = normalize(T_Normal * normal);
 
 	int cellID = int(cellIdAndType.x);
-	int highlightID = int(cellIdAndType.y);
+	int highlightID = hasLookupData ? int(texelFetch(lookupData, cellID & 0x3ff).r) : int(cellIdAndType.y);
 
 	ambient = kA;
 	e = 0;
@@ -0,0 +1,74 @@
+#version 330 core
+
+#define render geometry
+
+layout(location = 0) in vec3 vertexPos;
+layout(location = 1) in vec2 vertexUV;
+layout(location = 2) in vec3 normal;
+
+layout(location = 3) in mat4 T_M;
+layout(location = 7) in mat3 T_Normal;
+layout(location = 10) in mat4 T_MVP;
+
+// Five texels per instance: The four columns of the instance's transformation matrix and the (bit casted) cell ID.
+uniform samplerBuffer instanceData;
+
+// The highlight status of each cell of the chunk, indexed by the cell ID within the chunk (i.e. the lower 10 bits of the
+// cell ID).
+uniform usamplerBuffer lookupData;
+
+uniform int pick;
+
+uniform vec3 kA;
+out vec3 ambient;
+out float e;
+
+out vec2 uv;
+out vec3 world_normal;
+out vec3 world_pos;
+
+const vec3 highlightColors[3] = vec3[3](
+	vec3(0.0, 0.0, 0.0),	// No highlighting
+	vec3(0.0, 0.1, 0.0),	// Planned for construction
+	vec3(0.1, 0.0, 0.0)		// Planned for destruction
+);
+
+void main() {
+	mat4 instanceTransform = mat4(
+		texelFetch(instanceData, 5 * gl_InstanceID),
+		texelFetch(instanceData, 5 * gl_InstanceID + 1),
+		texelFetch(instanceData, 5 * gl_InstanceID + 2),
+		texelFetch(instanceData, 5 * gl_InstanceID + 3)
+	);
+	vec4 cell = texelFetch(instanceData, 5 * gl_InstanceID + 4);
+
+	vec4 instancePos = instanceTransform * vec4(vertexPos, 1);
+
+	// Instances are only rotated and uniformly scaled, so their normals can be transformed by the transformation itself.
+	vec3 instanceNormal = mat3(instanceTransform) * normal;
+
+	gl_Position = T_MVP * instancePos;
+
+	uv = vertexUV;
+
+	// output position and normal in world space for lighting calculations in
+	// the fragment shader
+	world_pos = (T_M * instancePos).xyz;
+	world_normal = normalize(T_Normal * instanceNormal);
+
+	int cellID = int(floatBitsToUint(cell.x));
+	int highlightID = int(texelFetch(lookupData, cellID & 0x3ff).r);
+
+	ambient = kA;
+	e = 0;
+
+	if ((pick & 0xffffff) == (cellID & 0xffffff)) {
+		ambient += vec3(0.1);
+		e = 2;
+	}
+
+	if (highlightID != 0) {
+		ambient += highlightColors[highlightID];
+		e = 2;
+	}
+}
@@ -0,0 +1,18 @@
+#version 330 core
+layout(location = 0) in vec3 vertexPos;
+
+layout(location = 10) in mat4 T_MVP;
+
+// See instanced.vert for the layout of the instance data.
+uniform samplerBuffer instanceData;
+
+void main() {
+	mat4 instanceTransform = mat4(
+		texelFetch(instanceData, 5 * gl_InstanceID),
+		texelFetch(instanceData, 5 * gl_InstanceID + 1),
+		texelFetch(instanceData, 5 * gl_InstanceID + 2),
+		texelFetch(instanceData, 5 * gl_InstanceID + 3)
+	);
+
+	gl_Position = T_MVP * instanceTransform * vec4(vertexPos, 1);
+}
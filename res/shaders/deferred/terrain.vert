@@ -12,6 +12,10 @@ layout(location = 10) in mat4 T_MVP;
 
 layout(location = 14) in uvec2 cellIdAndType;
 
+// The highlight status of each cell of the chunk, indexed by the cell ID within the chunk (i.e. the lower 10 bits of the
+// cell ID).
+uniform usamplerBuffer lookupData;
+
 uniform int pick;
 
 out vec2 uv;
@@ -53,6 +57,12 @@ const float specularCoeffs[4] = float[4](
 // https://gist.github.com/patriciogonzalezvivo/670c22f3966e662d2f83
 float rand(vec2 co){return fract(sin(dot(co.xy ,vec2(12.9898,78.233))) * 43758.5453);}
 
+const vec3 highlightColors[3] = vec3[3](
+	vec3(0.0, 0.0, 0.0),	// No highlighting
+	vec3(0.0, 0.1, 0.0),	// Planned for construction
+	vec3(0.1, 0.0, 0.0)		// Planned for destruction
+);
+
 void main() {
 	gl_Position = T_MVP * vec4(vertexPos, 1);
 
@@ -75,6 +85,12 @@ void main() {
 	n = 10;
 
 	e = 0;
+	int highlightID = int(texelFetch(lookupData, cellID & 0x3ff).r);
+	if (highlightID != 0) {
+		kA += highlightColors[highlightID];
+		e = 2;
+	}
+
 	if ((pick & 0xffffff) == (cellID & 0xffffff)) {
 		kA = vec3(0.1,0.1,0.3);
 		e = 2;
@@ -0,0 +1,32 @@
+#version 330 core
+layout(location = 0) in vec3 vertexPos;
+
+layout(location = 10) in mat4 T_MVP;
+
+// See deferred/building.vert for the layout of the instance data.
+uniform samplerBuffer instanceData;
+
+out vec3 vertexColor;
+
+vec2 interpolateBilinear(vec2 point, vec2 frontLeft, vec2 frontRight, vec2 backLeft, vec2 backRight) {
+	return (1 - point.x) * (1 - point.y) * frontLeft
+		+ point.x * (1 - point.y) * frontRight
+		+ (1 - point.x) * point.y * backLeft
+		+ point.x * point.y * backRight;
+}
+
+void main() {
+	vec4 frontCorners = texelFetch(instanceData, 3 * gl_InstanceID);
+	vec4 backCorners = texelFetch(instanceData, 3 * gl_InstanceID + 1);
+	vec4 heightsAndCell = texelFetch(instanceData, 3 * gl_InstanceID + 2);
+
+	float deltaHeight = heightsAndCell.y - heightsAndCell.x;
+	vec2 pos = interpolateBilinear(vertexPos.xz, frontCorners.xy, frontCorners.zw, backCorners.xy, backCorners.zw);
+	gl_Position = T_MVP * vec4(pos.x, vertexPos.y * deltaHeight + heightsAndCell.x, pos.y, 1);
+
+	int cellID = int(floatBitsToUint(heightsAndCell.z));
+	int r = (cellID >> 16) & 0xff;
+	int g = (cellID >> 8) & 0xff;
+	int b = (cellID >> 0) & 0xff;
+	vertexColor = vec3(r / 255.0, g / 255.0, b / 255.0);
+}
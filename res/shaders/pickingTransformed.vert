@@ -0,0 +1,27 @@
+#version 330 core
+layout(location = 0) in vec3 vertexPos;
+
+layout(location = 10) in mat4 T_MVP;
+
+// See deferred/instanced.vert for the layout of the instance data.
+uniform samplerBuffer instanceData;
+
+out vec3 vertexColor;
+
+void main() {
+	mat4 instanceTransform = mat4(
+		texelFetch(instanceData, 5 * gl_InstanceID),
+		texelFetch(instanceData, 5 * gl_InstanceID + 1),
+		texelFetch(instanceData, 5 * gl_InstanceID + 2),
+		texelFetch(instanceData, 5 * gl_InstanceID + 3)
+	);
+	vec4 cell = texelFetch(instanceData, 5 * gl_InstanceID + 4);
+
+	gl_Position = T_MVP * instanceTransform * vec4(vertexPos, 1);
+
+	int cellID = int(floatBitsToUint(cell.x));
+	int r = (cellID >> 16) & 0xff;
+	int g = (cellID >> 8) & 0xff;
+	int b = (cellID >> 0) & 0xff;
+	vertexColor = vec3(r / 255.0, g / 255.0, b / 255.0);
+}
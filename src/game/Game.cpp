@@ -17,9 +17,11 @@
 #include "components/FreeFlyingMoveController.hpp"
 #include "components/HeightConstrainedMoveController.hpp"
 #include "systems/MovementInputSystem.hpp"
+#include "systems/PopulationSystem.hpp"
 #include "systems/ResourceProcessingSystem.hpp"
 #include "DayNightCycle.hpp"
 #include "PickingChunkSelection.hpp"
+#include "SimulationTime.hpp"
 #include "world/buildings/Building.hpp"
 #include "world/buildings/WoodcutterBuilding.hpp"
 #include "world/Chunk.hpp"
@@ -46,6 +48,12 @@ namespace game
 	rendering::shading::Shader* simple;
 	rendering::shading::Shader* waterShader;
 	rendering::shading::Shader* terrainShader;
+	rendering::shading::Shader* buildingShader;
+	rendering::shading::Shader* buildingShadowShader;
+	rendering::shading::Shader* buildingPickingShader;
+	rendering::shading::Shader* instancedShader;
+	rendering::shading::Shader* instancedShadowShader;
+	rendering::shading::Shader* instancedPickingShader;
 
 	entt::entity cameraBase;
 	entt::entity defaultCamera;
@@ -72,6 +80,12 @@ namespace game
 		simple = new rendering::shading::Shader("simpleInstanced");
 		waterShader = new rendering::shading::LightSupportingShader("waterInstanced", true);
 		terrainShader = new rendering::shading::Shader("deferred/terrain");
+		buildingShader = new rendering::shading::Shader("deferred/building");
+		buildingShadowShader = new rendering::shading::Shader("deferred/buildingShadowZ");
+		buildingPickingShader = new rendering::shading::Shader("pickingBuilding");
+		instancedShader = new rendering::shading::Shader("deferred/instanced");
+		instancedShadowShader = new rendering::shading::Shader("deferred/instancedShadowZ");
+		instancedPickingShader = new rendering::shading::Shader("pickingTransformed");
 
 		tree = new rendering::model::Mesh("tree");
 
@@ -87,7 +101,7 @@ namespace game
 		auto& registry = renderingEngine->getRegistry();
 		registry.set<DayNightCycle>();
 
-		wrld = new world::World(256, registry, terrainShader, waterShader);
+		wrld = new world::World(256, registry, terrainShader, waterShader, buildingShader, buildingShadowShader, buildingPickingShader, instancedShader, instancedShadowShader, instancedPickingShader);
 		int worldSize = 8;
 		for (int column = -worldSize; column <= 0; column++)
 			for (int row = -worldSize - column; row <= worldSize; row++)
@@ -174,9 +188,9 @@ namespace game
 				if (selectedTool == gui::Tool::VIEW)
 					gui::openCellInfo(renderingEngine->getMousePosition(), renderingEngine->getFramebufferSize(), selected);
 				else if (selectedTool == gui::Tool::BUILD && selected != nullptr)
-					systems::enqueueConstruction(selected, selectedBuilding);
+					systems::enqueueConstruction(renderingEngine->getRegistry(), selected, selectedBuilding);
 				else if (selectedTool == gui::Tool::REMOVE && selected != nullptr)
-					systems::enqueueDestruction(selected);
+					systems::enqueueDestruction(renderingEngine->getRegistry(), selected);
 			}
 		}
 		pressed = pressedNew;
@@ -186,12 +200,15 @@ namespace game
 	double time = glfwGetTime();
 	void Game::update(rendering::RenderingEngine* renderingEngine, double deltaTime)
 	{
+		auto& registry = renderingEngine->getRegistry();
+
+		advanceSimulationTime(registry, deltaTime);
 		wrld->update();
 
-		auto& registry = renderingEngine->getRegistry();
 		auto& daynight = registry.ctx<DayNightCycle>();
 
-		systems::updateResourceProcessingSystem(registry, deltaTime, wrld->getHeightGenerator());
+		systems::updateResourceProcessingSystem(registry, deltaTime);
+		systems::updatePopulationSystem(registry);
 
 		daynight.update(deltaTime);
 		auto sunDir = glm::normalize(daynight.getSunDirection());
@@ -224,6 +241,15 @@ namespace game
 		auto camPointer = selectedCamera == gui::CameraType::DEFAULT ? defaultCamera : freeFlightCamera;
 		renderingEngine->setMainCamera(camPointer);
 
+		auto& camera = registry.get<rendering::components::Camera>(camPointer);
+		systems::updateDroneAnimations(registry, camera.getClippingPlanes(), wrld->getHeightGenerator());
+
+		// Buildings around the point the player is looking at are simulated at full rate.
+		glm::vec3 focus = selectedCamera == gui::CameraType::DEFAULT
+			? baseTf.getTranslation()
+			: registry.get<rendering::components::EulerComponentwiseTransform>(freeFlightCamera).getTranslation();
+		systems::updateSimulationFocus(registry, glm::vec2(focus.x, focus.z));
+
 		selectChunks(registry, renderingEngine, wrld);
 	}
 	
@@ -238,7 +264,7 @@ namespace game
 		skybox->render(renderingEngine);
 
 		gui::renderCellInfo(renderingEngine->getRegistry());
-		gui::renderDebugWindow(daynight, &selectedCamera);
+		gui::renderDebugWindow(renderingEngine->getRegistry(), daynight, &selectedCamera);
 		gui::renderToolSelection(&selectedTool, &selectedBuilding, renderingEngine->getFramebufferHeight());
 
 	}
@@ -39,7 +39,8 @@ namespace game
 			if (dist <= radius && height >= 0)
 			{
 				picking.enabled.insert(chunk->getLandscapeMesh());
-				picking.enabled.insert(chunk->getCellContentMesh());
+				chunk->collectDeformedMeshes(picking.enabled);
+				chunk->collectTransformedMeshes(picking.enabled);
 			}
 		}
 	}
@@ -0,0 +1,15 @@
+#include "SimulationTime.hpp"
+
+namespace game
+{
+	double getSimulationTime(const entt::registry& registry)
+	{
+		const SimulationClock* clock = registry.try_ctx<SimulationClock>();
+		return clock != nullptr ? clock->time : 0.0;
+	}
+
+	void advanceSimulationTime(entt::registry& registry, double deltaTime)
+	{
+		registry.ctx_or_set<SimulationClock>().time += deltaTime;
+	}
+}
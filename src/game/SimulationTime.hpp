@@ -0,0 +1,18 @@
+#pragma once
+
+#include <entt/entt.hpp>
+
+namespace game
+{
+	// The simulation has its own clock which is only advanced when the game is updated. This allows the simulation to
+	// run independently from any window (e.g. when running headless) and with arbitrary time steps. Each registry has its
+	// own clock, so that multiple worlds can be simulated side by side.
+	struct SimulationClock
+	{
+		double time{ 0.0 };
+	};
+
+	double getSimulationTime(const entt::registry& registry);
+
+	void advanceSimulationTime(entt::registry& registry, double deltaTime);
+}
@@ -0,0 +1,278 @@
+#include "PopulationSystem.hpp"
+
+namespace game::systems
+{
+	// The population is stored in the context of the registry, so that each world has its own citizens.
+	struct PopulationContext
+	{
+		Population population;
+
+		size_t currentSlice = 0;
+		std::array<double, world::POPULATION_UPDATE_STAGGER> sliceLastUpdated;
+		bool sliceLastUpdatedInitialized = false;
+
+		// Workplaces which may have open jobs. Entries may be outdated, so they must be checked before assigning a job.
+		std::vector<entt::entity> openWorkplaces;
+
+		// The indices of citizens which need to be processed serially after the parallel update, one vector per batch.
+		std::vector<std::vector<uint32_t>> citizensToProcess;
+		std::vector<size_t> batchIndices;
+		std::vector<uint32_t> citizensToRemove;
+	};
+
+	PopulationContext& getPopulationContext(entt::registry& registry)
+	{
+		return registry.ctx_or_set<PopulationContext>();
+	}
+
+	void removeCitizen(entt::registry& registry, size_t index)
+	{
+		auto& context = getPopulationContext(registry);
+		Population& population = context.population;
+
+		entt::entity workplace = population.workplace[index];
+		if (workplace != entt::null && registry.valid(workplace))
+		{
+			auto& workplaceComponent = registry.get<Workplace>(workplace);
+			workplaceComponent.assigned--;
+			if (population.state[index] == CitizenState::WORKING)
+				workplaceComponent.workers--;
+			context.openWorkplaces.push_back(workplace);
+		}
+
+		entt::entity home = population.home[index];
+		auto* residents = registry.valid(home) ? registry.try_get<Residents>(home) : nullptr;
+		if (residents != nullptr)
+			residents->amount--;
+
+		size_t last = population.size() - 1;
+		population.home[index] = population.home[last];
+		population.homeCell[index] = population.homeCell[last];
+		population.hunger[index] = population.hunger[last];
+		population.state[index] = population.state[last];
+		population.workplace[index] = population.workplace[last];
+
+		population.home.pop_back();
+		population.homeCell.pop_back();
+		population.hunger.pop_back();
+		population.state.pop_back();
+		population.workplace.pop_back();
+	}
+
+	void assignWorkplace(entt::registry& registry, size_t index)
+	{
+		auto& context = getPopulationContext(registry);
+		Population& population = context.population;
+
+		while (!context.openWorkplaces.empty())
+		{
+			entt::entity workplace = context.openWorkplaces.back();
+			if (registry.valid(workplace))
+			{
+				auto& workplaceComponent = registry.get<Workplace>(workplace);
+				if (workplaceComponent.assigned < workplaceComponent.jobs)
+				{
+					workplaceComponent.assigned++;
+					population.workplace[index] = workplace;
+					return;
+				}
+			}
+
+			context.openWorkplaces.pop_back();
+		}
+	}
+
+	void updateCitizens(
+		entt::registry& registry,
+		PopulationContext& context,
+		size_t begin,
+		size_t end,
+		float elapsed,
+		std::vector<uint32_t>& toProcess
+	) {
+		Population& population = context.population;
+
+		// Citizens of the same residence are mostly stored next to each other, so the residence's food supply only needs
+		// to be looked up when the home changes.
+		entt::entity lastHome = entt::null;
+		float foodSupply = 0.0f;
+		bool hasOpenJobs = !context.openWorkplaces.empty();
+
+		for (size_t i = begin; i < end; i++)
+		{
+			entt::entity home = population.home[i];
+			if (home != lastHome)
+			{
+				lastHome = home;
+				auto* residents = registry.valid(home) ? registry.try_get<Residents>(home) : nullptr;
+				if (residents == nullptr)
+				{
+					// The residence doesn't exist anymore, so the citizen must be removed.
+					lastHome = entt::null;
+					toProcess.push_back(i);
+					continue;
+				}
+				foodSupply = residents->foodSupply;
+			}
+
+			// Citizens get hungry while their residence lacks food and recover while it is supplied.
+			float hunger = population.hunger[i] + elapsed * world::CITIZEN_HUNGER_RATE * (1.0f - 2.0f * foodSupply);
+			population.hunger[i] = std::clamp(hunger, 0.0f, 1.0f);
+
+			entt::entity workplace = population.workplace[i];
+			bool starving = population.hunger[i] >= world::CITIZEN_STARVING_HUNGER;
+			bool workplaceLost = workplace != entt::null && !registry.valid(workplace);
+			bool needsJob = workplace == entt::null && !starving && hasOpenJobs;
+			bool stateChanged = starving != (population.state[i] == CitizenState::STARVING);
+			if (workplaceLost || needsJob || stateChanged)
+				toProcess.push_back(i);
+		}
+	}
+
+	// Applies all changes to a citizen which require modifying shared data (i.e. workplaces and residences).
+	void processCitizen(entt::registry& registry, uint32_t index)
+	{
+		auto& context = getPopulationContext(registry);
+		Population& population = context.population;
+
+		entt::entity home = population.home[index];
+		if (!registry.valid(home) || !registry.has<Residents>(home))
+		{
+			context.citizensToRemove.push_back(index);
+			return;
+		}
+
+		entt::entity& workplace = population.workplace[index];
+		if (workplace != entt::null && !registry.valid(workplace))
+		{
+			workplace = entt::null;
+			population.state[index] = CitizenState::UNEMPLOYED;
+		}
+
+		bool starving = population.hunger[index] >= world::CITIZEN_STARVING_HUNGER;
+		if (!starving && workplace == entt::null)
+			assignWorkplace(registry, index);
+
+		CitizenState newState = CitizenState::UNEMPLOYED;
+		if (starving)
+			newState = CitizenState::STARVING;
+		else if (workplace != entt::null)
+			newState = CitizenState::WORKING;
+
+		CitizenState& state = population.state[index];
+		if (workplace != entt::null && state != newState)
+		{
+			auto& workplaceComponent = registry.get<Workplace>(workplace);
+			if (state == CitizenState::WORKING)
+				workplaceComponent.workers--;
+			else if (newState == CitizenState::WORKING)
+				workplaceComponent.workers++;
+		}
+		state = newState;
+	}
+
+	void updatePopulationSystem(entt::registry& registry)
+	{
+		auto& context = getPopulationContext(registry);
+		Population& population = context.population;
+
+		double time = getSimulationTime(registry);
+		if (!context.sliceLastUpdatedInitialized)
+		{
+			context.sliceLastUpdated.fill(time);
+			context.sliceLastUpdatedInitialized = true;
+		}
+
+		size_t slice = context.currentSlice;
+		context.currentSlice = (context.currentSlice + 1) % world::POPULATION_UPDATE_STAGGER;
+		float elapsed = (float) (time - context.sliceLastUpdated[slice]);
+		context.sliceLastUpdated[slice] = time;
+
+		size_t sliceBegin = population.size() * slice / world::POPULATION_UPDATE_STAGGER;
+		size_t sliceEnd = population.size() * (slice + 1) / world::POPULATION_UPDATE_STAGGER;
+		size_t amountOfBatches = (sliceEnd - sliceBegin + world::POPULATION_UPDATE_BATCH_SIZE - 1) / world::POPULATION_UPDATE_BATCH_SIZE;
+		if (amountOfBatches == 0)
+			return;
+
+		if (context.citizensToProcess.size() < amountOfBatches)
+			context.citizensToProcess.resize(amountOfBatches);
+		context.batchIndices.resize(amountOfBatches);
+		std::iota(context.batchIndices.begin(), context.batchIndices.end(), 0);
+
+		// Views must not be created concurrently, as creating a view creates the component pool if it doesn't exist yet.
+		registry.view<Residents>();
+		registry.view<Workplace>();
+
+		std::for_each(std::execution::par, context.batchIndices.begin(), context.batchIndices.end(), [&](size_t batch) {
+			size_t begin = sliceBegin + batch * world::POPULATION_UPDATE_BATCH_SIZE;
+			size_t end = std::min(begin + world::POPULATION_UPDATE_BATCH_SIZE, sliceEnd);
+			updateCitizens(registry, context, begin, end, elapsed, context.citizensToProcess[batch]);
+		});
+
+		for (size_t batch = 0; batch < amountOfBatches; batch++)
+		{
+			for (uint32_t index : context.citizensToProcess[batch])
+				processCitizen(registry, index);
+			context.citizensToProcess[batch].clear();
+		}
+
+		// Removing a citizen moves the last citizen to its index, so citizens must be removed from back to front.
+		std::sort(context.citizensToRemove.begin(), context.citizensToRemove.end(), std::greater<uint32_t>());
+		for (uint32_t index : context.citizensToRemove)
+			removeCitizen(registry, index);
+		context.citizensToRemove.clear();
+	}
+
+	void setResidentCapacity(entt::registry& registry, entt::entity residence, uint32_t homeCell, uint32_t capacity)
+	{
+		auto& context = getPopulationContext(registry);
+		Population& population = context.population;
+
+		auto& residents = registry.get_or_emplace<Residents>(residence);
+		residents.capacity = capacity;
+
+		for (size_t index = population.size(); index > 0 && residents.amount > capacity; index--)
+			if (population.home[index - 1] == residence)
+				removeCitizen(registry, index - 1);
+
+		for (; residents.amount < capacity; residents.amount++)
+		{
+			population.home.push_back(residence);
+			population.homeCell.push_back(homeCell);
+			population.hunger.push_back(0.0f);
+			population.state.push_back(CitizenState::UNEMPLOYED);
+			population.workplace.push_back(entt::null);
+		}
+	}
+
+	void setJobCapacity(entt::registry& registry, entt::entity workplace, uint32_t jobs)
+	{
+		auto& context = getPopulationContext(registry);
+		Population& population = context.population;
+
+		auto& workplaceComponent = registry.get_or_emplace<Workplace>(workplace);
+		workplaceComponent.jobs = jobs;
+
+		for (size_t index = population.size(); index > 0 && workplaceComponent.assigned > jobs; index--)
+		{
+			if (population.workplace[index - 1] == workplace)
+			{
+				if (population.state[index - 1] == CitizenState::WORKING)
+				{
+					workplaceComponent.workers--;
+					population.state[index - 1] = CitizenState::UNEMPLOYED;
+				}
+				workplaceComponent.assigned--;
+				population.workplace[index - 1] = entt::null;
+			}
+		}
+
+		if (workplaceComponent.assigned < jobs)
+			context.openWorkplaces.push_back(workplace);
+	}
+
+	const Population& getPopulation(entt::registry& registry)
+	{
+		return getPopulationContext(registry).population;
+	}
+}
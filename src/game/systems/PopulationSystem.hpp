@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "../SimulationTime.hpp"
+#include "../world/Constants.hpp"
+
+namespace game::systems
+{
+	enum class CitizenState : uint8_t
+	{
+		UNEMPLOYED, WORKING, STARVING
+	};
+
+	// All citizens are stored as a structure of arrays, i.e. the citizen with index i is described by the i-th element of
+	// each array. Updating the citizens therefore only touches the data which is actually needed, and the loops over the
+	// contiguous arrays can be vectorized by the compiler.
+	struct Population
+	{
+		std::vector<entt::entity> home;
+		std::vector<uint32_t> homeCell;
+		std::vector<float> hunger;
+		std::vector<CitizenState> state;
+		std::vector<entt::entity> workplace;
+
+		size_t size() const
+		{
+			return home.size();
+		}
+	};
+
+	// Attached to residences. The food supply is the share of the residents' food demand which could be satisfied by the
+	// residence's last meal.
+	struct Residents
+	{
+		uint32_t capacity{ 0 };
+		uint32_t amount{ 0 };
+		float foodSupply{ 1.0f };
+	};
+
+	// Attached to buildings offering jobs. Assigned citizens which are starving keep their job, but they don't count as
+	// workers until they are fed again.
+	struct Workplace
+	{
+		uint32_t jobs{ 0 };
+		uint32_t assigned{ 0 };
+		uint32_t workers{ 0 };
+	};
+
+	// Updates one of POPULATION_UPDATE_STAGGER slices of the population, so that each citizen is updated every
+	// POPULATION_UPDATE_STAGGER ticks. The slice is split into batches which are updated in parallel.
+	void updatePopulationSystem(entt::registry& registry);
+
+	// Moves citizens into or out of the given residence until it houses the given amount of citizens.
+	void setResidentCapacity(entt::registry& registry, entt::entity residence, uint32_t homeCell, uint32_t capacity);
+
+	// Changes the amount of jobs offered by the given workplace. Citizens are laid off if there are less jobs than before.
+	void setJobCapacity(entt::registry& registry, entt::entity workplace, uint32_t jobs);
+
+	const Population& getPopulation(entt::registry& registry);
+}
@@ -2,18 +2,31 @@
 
 namespace game::systems
 {
-	float droneMovementSpeedMultiplier = 1.0f;
+	struct ScheduledResourceProcessing
+	{
+		double time;
+		entt::entity entity;
+		IResourceProcessor* resourceProcessor;
+	};
 
-	std::unordered_set<IResourceProcessor*> resourceProcessors;
-	std::unordered_set<std::shared_ptr<world::IItem>, world::IItemHash, world::IItemComparator> itemTypes;
+	struct EarliestResourceProcessing
+	{
+		bool operator() (const ScheduledResourceProcessing& a, const ScheduledResourceProcessing& b)
+		{
+			return a.time > b.time;
+		}
+	};
 
-	std::queue<std::pair<world::Cell*, world::IBuilding*>> buildingsToPlace;
-	std::queue<world::Cell*> buildingsToRemove;
+	struct ConstructionOrder
+	{
+		world::Cell* cell;
+		world::IBuilding* buildingType;
+	};
 
 	struct EntityAmount
 	{
 		entt::entity entity;
-		std::shared_ptr<world::IItem> itemType;
+		world::IItem* itemType;
 		float amount;
 	};
 
@@ -33,133 +46,286 @@ namespace game::systems
 		}
 	};
 
-	std::priority_queue<EntityAmount, std::vector<EntityAmount>, MaxPriorityQueue> filledProducers;
-	std::priority_queue<EntityAmount, std::vector<EntityAmount>, MinPriorityQueue> starvingConsumers;
-
 	struct PlannedInventoryChanges
 	{
 		world::Inventory plannedPickups;
 		world::Inventory plannedDeliveries;
 	};
 
-	std::unordered_map<entt::entity, PlannedInventoryChanges> plannedInventoryChanges;
+	struct DroneArrival
+	{
+		double time;
+		entt::entity entity;
+	};
+
+	struct EarliestArrival
+	{
+		bool operator() (const DroneArrival& a, const DroneArrival& b)
+		{
+			return a.time > b.time;
+		}
+	};
+
+	// The per frame animation state of a drone.
+	struct DroneAnimation
+	{
+		entt::entity entity;
+		glm::vec2 position;
+		float height;
+		bool animate;
+	};
+
+	// The buffers used for animating the drones. They are kept between frames, so that animating the drones doesn't
+	// allocate once the buffers have grown to the amount of drones.
+	struct DroneAnimations
+	{
+		std::vector<DroneAnimation> drones;
+		std::vector<uint32_t> buckets;
+		util::SpatialHash spatialHash{ world::DRONE_SEPARATION_RADIUS };
+	};
+
+	// The state of the resource processing system is stored in the context of the registry, so that each world is simulated
+	// independently of all other worlds. The resource processors of the buildings are stateless and can therefore be shared
+	// by all worlds.
+	struct ResourceProcessingContext
+	{
+		float droneMovementSpeedMultiplier = 1.0f;
+
+		std::priority_queue<ScheduledResourceProcessing, std::vector<ScheduledResourceProcessing>, EarliestResourceProcessing> scheduledResourceProcessings;
+
+		// The resource processor of each scheduled entity, needed for catching up on deferred production steps on demand.
+		std::unordered_map<entt::entity, IResourceProcessor*> resourceProcessors;
+
+		bool hasSimulationFocus = false;
+		glm::vec2 simulationFocus;
+		glm::vec2 lastRefocus;
+
+		// Construction orders are kept in a backlog which is indexed by region, so that drones only consider orders near
+		// them. Orders which can't be scheduled as some required item isn't available anywhere are moved out of the backlog.
+		// They are indexed by the missing item type and only return to the backlog once items of that type become available.
+		std::unordered_map<int64_t, std::vector<ConstructionOrder>> constructionBacklog;
+		size_t amountOfOrdersInConstructionBacklog = 0;
+		glm::ivec2 minConstructionRegion{ 0 };
+		glm::ivec2 maxConstructionRegion{ 0 };
+		std::array<std::vector<ConstructionOrder>, world::AMOUNT_OF_ITEM_TYPES> ordersWaitingForItems;
+		std::queue<world::Cell*> buildingsToRemove;
+
+		// The queues of filled producers and starving consumers are maintained incrementally. Only entities whose inventory
+		// or planned inventory changes changed since the last update are re-evaluated, so that idle buildings don't cost
+		// anything. As the amounts of queued entities may change while they are queued, they are checked again when they
+		// are taken from the queue (see popEntityAmount).
+		std::priority_queue<EntityAmount, std::vector<EntityAmount>, MaxPriorityQueue> filledProducers;
+		std::priority_queue<EntityAmount, std::vector<EntityAmount>, MinPriorityQueue> starvingConsumers;
+		std::unordered_set<uint64_t> queuedEntityAmounts;
+		std::unordered_set<entt::entity> entitiesWithChangedInventory;
+
+		std::unordered_map<entt::entity, PlannedInventoryChanges> plannedInventoryChanges;
+
+		// The pickups and deliveries a drone performs during a single trip. The stops are kept in a buffer which is reused
+		// for all drones (routes are only built during the sequential commit phase), so that building a route doesn't
+		// allocate.
+		std::vector<world::DroneTask> routeStops;
+
+		std::priority_queue<DroneArrival, std::vector<DroneArrival>, EarliestArrival> droneArrivals;
+
+		DroneAnimations droneAnimations;
+	};
+
+	// The context is created sequentially at the latest by the first update of the system. Afterwards, it is only looked up,
+	// which is safe during the parallel phase of the drone update.
+	ResourceProcessingContext& getResourceProcessingContext(entt::registry& registry)
+	{
+		return registry.ctx_or_set<ResourceProcessingContext>();
+	}
+
+	// Marks the entity to be re-evaluated as a filled producer or starving consumer during the next update.
+	void markInventoryChanged(entt::registry& registry, entt::entity entity)
+	{
+		getResourceProcessingContext(registry).entitiesWithChangedInventory.insert(entity);
+	}
 
-	struct PlannedInventoryChange
+	uint64_t getEntityAmountKey(entt::entity entity, world::IItem* itemType, bool consumer)
 	{
-		entt::entity contentEntity;
-		std::shared_ptr<world::IItem> itemAndAmount;
-		bool finished;
+		return (uint64_t(entity) << 32) | (uint64_t(itemType->index) << 1) | (consumer ? 1 : 0);
+	}
 
-		PlannedInventoryChange(entt::entity _contentEntity, std::shared_ptr<world::IItem> _itemAndAmount)
-			: contentEntity(_contentEntity), itemAndAmount(_itemAndAmount), finished(false) {}
+	// Returns the amount of items the producer or consumer will store once all planned pickups (for producers) or planned
+	// deliveries (for consumers) are executed.
+	float getPlannedAmount(entt::registry& registry, entt::entity entity, world::IItem* itemType, bool consumer)
+	{
+		float plannedAmount = registry.get<world::Inventory>(entity).getStoredAmount(itemType);
 
-		float execute(entt::registry& registry, entt::entity droneEntity, entt::entity destinationEntity)
+		auto& plannedInventoryChanges = getResourceProcessingContext(registry).plannedInventoryChanges;
+		auto found = plannedInventoryChanges.find(entity);
+		if (found != plannedInventoryChanges.end())
 		{
-			if (finished)
-				return 0.0f;
+			if (consumer)
+				plannedAmount += found->second.plannedDeliveries.getStoredAmount(itemType);
+			else
+				plannedAmount -= found->second.plannedPickups.getStoredAmount(itemType);
+		}
 
-			entt::entity entityToInteractWith = contentEntity;
-			if (!registry.valid(contentEntity) || contentEntity != destinationEntity)
-				entityToInteractWith = destinationEntity;
+		return plannedAmount;
+	}
 
-			world::Inventory& contentInventory = registry.get<world::Inventory>(entityToInteractWith);
-			world::Inventory& droneInventory = registry.get<world::Inventory>(droneEntity);
+	bool needsTransport(float plannedAmount, bool consumer)
+	{
+		return consumer
+			? plannedAmount <= world::RESOURCE_MANAGEMENT_RESUPPLY_CONSUMER_UNDER
+			: plannedAmount >= world::RESOURCE_MANAGEMENT_EMPTY_PRODUCER_ABOVE;
+	}
 
-			world::Inventory& sourceInventory = getSourceInventory(contentInventory, droneInventory);
-			world::Inventory& destinationInventory = getDestinationInventory(contentInventory, droneInventory);
+	template <class Queue>
+	void pushEntityAmount(ResourceProcessingContext& context, Queue& queue, const EntityAmount& entityAmount, bool consumer)
+	{
+		if (context.queuedEntityAmounts.insert(getEntityAmountKey(entityAmount.entity, entityAmount.itemType, consumer)).second)
+			queue.push(entityAmount);
+	}
 
-			std::shared_ptr<world::IItem> item = sourceInventory.removeItem(itemAndAmount, itemAndAmount->amount);
-			if (item == nullptr)
+	// Takes the most urgent entity from the queue. Entities which no longer need a transport are dropped, and entities whose
+	// amount changed while they were queued are queued again with their current amount.
+	template <class Queue>
+	bool popEntityAmount(entt::registry& registry, Queue& queue, bool consumer, EntityAmount& result)
+	{
+		auto& context = getResourceProcessingContext(registry);
+		while (!queue.empty())
+		{
+			EntityAmount entityAmount = queue.top();
+			queue.pop();
+
+			if (!registry.valid(entityAmount.entity))
 			{
-				cancel(registry);
-				return 0.0f;
+				context.queuedEntityAmounts.erase(getEntityAmountKey(entityAmount.entity, entityAmount.itemType, consumer));
+				continue;
 			}
-			destinationInventory.addItem(item);
 
-			registry.get<world::CellContentComponent>(entityToInteractWith).cellContent->inventoryUpdated();
-			registry.get<world::Drone>(droneEntity).inventoryUpdated(registry, droneEntity, droneInventory);
+			float plannedAmount = getPlannedAmount(registry, entityAmount.entity, entityAmount.itemType, consumer);
+			if (!needsTransport(plannedAmount, consumer))
+			{
+				context.queuedEntityAmounts.erase(getEntityAmountKey(entityAmount.entity, entityAmount.itemType, consumer));
+				continue;
+			}
 
-			cancel(registry);
+			if (plannedAmount != entityAmount.amount)
+			{
+				entityAmount.amount = plannedAmount;
+				queue.push(entityAmount);
+				continue;
+			}
 
-			return item->amount;
+			context.queuedEntityAmounts.erase(getEntityAmountKey(entityAmount.entity, entityAmount.itemType, consumer));
+			result = entityAmount;
+			return true;
 		}
 
-		void cancel(entt::registry& registry)
+		return false;
+	}
+
+	void updateFilledProducersAndStarvingConsumers(entt::registry& registry)
+	{
+		auto& context = getResourceProcessingContext(registry);
+		for (entt::entity entity : context.entitiesWithChangedInventory)
 		{
-			if (finished)
-				return;
+			if (!registry.valid(entity))
+				continue;
 
-			getPlanningInventory().removeItem(itemAndAmount, itemAndAmount->amount);
-			if (!registry.valid(contentEntity))
-				plannedInventoryChanges.erase(contentEntity);
+			world::forEachItemType([&registry, &context, entity](auto* itemTypeTag) {
+				using ItemType = std::remove_pointer_t<decltype(itemTypeTag)>;
+				world::IItem* itemType = ItemType::getTypeRepresentative();
 
-			finished = true;
-		}
+				if (registry.has<world::Consumes<ItemType>>(entity))
+				{
+					float plannedAmount = getPlannedAmount(registry, entity, itemType, true);
+					if (needsTransport(plannedAmount, true))
+						pushEntityAmount(context, context.starvingConsumers, EntityAmount{ entity, itemType, plannedAmount }, true);
+				}
 
-		virtual world::Inventory& getPlanningInventory() = 0;
+				if (registry.has<world::Produces<ItemType>>(entity))
+				{
+					float plannedAmount = getPlannedAmount(registry, entity, itemType, false);
+					if (needsTransport(plannedAmount, false))
+						pushEntityAmount(context, context.filledProducers, EntityAmount{ entity, itemType, plannedAmount }, false);
+				}
+			});
+		}
+		context.entitiesWithChangedInventory.clear();
+	}
 
-		virtual world::Inventory& getSourceInventory(
-			world::Inventory& contentInventory,
-			world::Inventory& droneInventory
-		) = 0;
+	world::Inventory& getPlanningInventory(entt::registry& registry, world::DroneTask& task)
+	{
+		PlannedInventoryChanges& plannedChanges = getResourceProcessingContext(registry).plannedInventoryChanges[task.plannedChangeEntity];
+		if (task.type == world::DroneTaskType::PICKUP)
+			return plannedChanges.plannedPickups;
+		else
+			return plannedChanges.plannedDeliveries;
+	}
 
-		virtual world::Inventory& getDestinationInventory(
-			world::Inventory& contentInventory,
-			world::Inventory& droneInventory
-		) = 0;
-	};
+	void planInventoryChange(entt::registry& registry, world::DroneTask& task, entt::entity contentEntity)
+	{
+		task.plannedChangeEntity = contentEntity;
+		getPlanningInventory(registry, task).addItem(task.itemType, task.amount);
+		markInventoryChanged(registry, contentEntity);
+	}
 
-	struct PlannedPickup : public PlannedInventoryChange
+	void cancelPlannedInventoryChange(entt::registry& registry, world::DroneTask& task)
 	{
-		PlannedPickup(entt::entity _contentEntity, std::shared_ptr<world::IItem> _itemAndAmount)
-			: PlannedInventoryChange(_contentEntity, _itemAndAmount)
-		{
-			getPlanningInventory().addItem(itemAndAmount->clone());
-		}
+		if (task.plannedChangeEntity == entt::null)
+			return;
 
-		PlannedPickup(const PlannedPickup& other) : PlannedInventoryChange(other.contentEntity, other.itemAndAmount) {}
+		getPlanningInventory(registry, task).removeItem(task.itemType, task.amount);
+		if (!registry.valid(task.plannedChangeEntity))
+			getResourceProcessingContext(registry).plannedInventoryChanges.erase(task.plannedChangeEntity);
+		else
+			markInventoryChanged(registry, task.plannedChangeEntity);
 
-		world::Inventory& getPlanningInventory()
-		{
-			return plannedInventoryChanges[contentEntity].plannedPickups;
-		}
+		task.plannedChangeEntity = entt::null;
+	}
 
-		world::Inventory& getSourceInventory(world::Inventory& contentInventory, world::Inventory& droneInventory)
-		{
-			return contentInventory;
-		}
+	float executePlannedInventoryChange(
+		entt::registry& registry,
+		entt::entity droneEntity,
+		world::DroneTask& task,
+		entt::entity destinationEntity
+	) {
+		if (task.plannedChangeEntity == entt::null)
+			return 0.0f;
 
-		world::Inventory& getDestinationInventory(world::Inventory& contentInventory, world::Inventory& droneInventory)
-		{
-			return droneInventory;
-		}
-	};
+		entt::entity entityToInteractWith = task.plannedChangeEntity;
+		if (!registry.valid(task.plannedChangeEntity) || task.plannedChangeEntity != destinationEntity)
+			entityToInteractWith = destinationEntity;
 
-	struct PlannedDelivery : public PlannedInventoryChange
-	{
-		PlannedDelivery(entt::entity _contentEntity, std::shared_ptr<world::IItem> _itemAndAmount)
-			: PlannedInventoryChange(_contentEntity, _itemAndAmount)
-		{
-			getPlanningInventory().addItem(itemAndAmount->clone());
-		}
+		catchUpResourceProcessing(registry, entityToInteractWith);
 
-		PlannedDelivery(const PlannedPickup& other) : PlannedInventoryChange(other.contentEntity, other.itemAndAmount) {}
+		world::Inventory& contentInventory = registry.get<world::Inventory>(entityToInteractWith);
+		world::Inventory& droneInventory = registry.get<world::Inventory>(droneEntity);
 
-		world::Inventory& getPlanningInventory()
-		{
-			return plannedInventoryChanges[contentEntity].plannedPickups;
-		}
+		bool pickup = task.type == world::DroneTaskType::PICKUP;
+		world::Inventory& sourceInventory = pickup ? contentInventory : droneInventory;
+		world::Inventory& destinationInventory = pickup ? droneInventory : contentInventory;
 
-		world::Inventory& getSourceInventory(world::Inventory& contentInventory, world::Inventory& droneInventory)
+		float amount = sourceInventory.removeItem(task.itemType, task.amount);
+		if (amount <= 0.0f)
 		{
-			return droneInventory;
+			cancelPlannedInventoryChange(registry, task);
+			return 0.0f;
 		}
+		destinationInventory.addItem(task.itemType, amount);
+		markInventoryChanged(registry, entityToInteractWith);
 
-		world::Inventory& getDestinationInventory(world::Inventory& contentInventory, world::Inventory& droneInventory)
-		{
-			return contentInventory;
-		}
-	};
+		registry.get<world::CellContentComponent>(entityToInteractWith).cellContent->inventoryUpdated();
+		registry.get<world::Drone>(droneEntity).inventoryUpdated(registry, droneEntity, droneInventory);
+
+		cancelPlannedInventoryChange(registry, task);
+
+		return amount;
+	}
+
+	// The transforms of drones are only updated while they are visible, so the drone's position must be evaluated from its
+	// current leg instead.
+	glm::vec2 getDronePosition(entt::registry& registry, entt::entity entity)
+	{
+		return registry.get<world::Drone>(entity).leg.getPosition(getSimulationTime(registry));
+	}
 
 	world::Cell* findNearestCell(glm::vec2 dronePosition, world::CellContent* destination)
 	{
@@ -189,58 +355,68 @@ namespace game::systems
 		entt::entity& entity,
 		world::CellContent* destination
 	) {
-		auto& transform = registry.get<rendering::components::EulerComponentwiseTransform>(entity);
-		glm::vec2 dronePosition = glm::vec2(transform.getTranslation().x, transform.getTranslation().z);
+		return findNearestCell(getDronePosition(registry, entity), destination);
+	}
+
+	template <class ItemScoreFunc>
+	inline void scoreCandidate(
+		float& currentBestScore,
+		world::CellContent*& bestMatch,
+		entt::registry& registry,
+		glm::vec2 dronePos,
+		ItemScoreFunc& getItemScore,
+		entt::entity candidate
+	) {
+		// Calculate the distance from the drone to the candidate.
+		world::CellContent* candidateCellContent = registry.get<world::CellContentComponent>(candidate).cellContent;
+		world::Cell* nearestCell = findNearestCell(dronePos, candidateCellContent);
+		float distanceScore = -glm::distance(dronePos, nearestCell->getRelaxedPosition());
+
+		// Calculate the candidate's item score (i.e. how preferred the candidate would be selected based on the amount
+		// of stored items and planned changes to the candidate's inventory).
+		world::Inventory& candidateInventory = registry.get<world::Inventory>(candidate);
+		auto& plannedInventoryChanges = getResourceProcessingContext(registry).plannedInventoryChanges;
+		PlannedInventoryChanges* plannedChanges = nullptr;
+		auto& found = plannedInventoryChanges.find(candidate);
+		if (found != plannedInventoryChanges.end())
+			plannedChanges = &found->second;
+		float itemScore = getItemScore(candidateInventory, plannedChanges);
+		if (itemScore == std::numeric_limits<float>::lowest())
+			return;
 
-		return findNearestCell(dronePosition, destination);
+		// Check if the current candidate is better than the current best, and update the current best accordingly.
+		float totalScore = distanceScore * world::RESOURCE_MANAGEMENT_CANDIDATE_PLANNING_DISTANCE_WEIGHT
+			+ itemScore * world::RESOURCE_MANAGEMENT_CANDIDATE_PLANNING_ITEMS_WEIGHT;
+		if (totalScore > currentBestScore)
+		{
+			currentBestScore = totalScore;
+			bestMatch = candidateCellContent;
+		}
 	}
 
-	template <class ItemInteraction>
+	// Both the item interaction and the score function are template parameters, so that the candidate scoring is compiled
+	// directly into the loop over the view instead of being called through a std::function for each candidate.
+	template <class ItemInteraction, class ItemScoreFunc>
 	void findBestCandidate(
 		float& currentBestScore,
 		world::CellContent*& bestMatch,
 		entt::registry& registry,
 		glm::vec2 dronePos,
-		std::shared_ptr<world::IItem> item,
-		std::function<float(world::Inventory&, PlannedInventoryChanges*)>& getItemScore,
-		ItemInteraction* candidates
+		ItemScoreFunc& getItemScore
 	) {
-		candidates->iterateAllEntities(registry, std::function([&currentBestScore, &bestMatch, &registry, item, &getItemScore, dronePos](entt::entity& candidate, ItemInteraction* interaction) {
-			// Calculate the distance from the drone to the candidate.
-			world::CellContent* candidateCellContent = registry.get<world::CellContentComponent>(candidate).cellContent;
-			world::Cell* nearestCell = findNearestCell(dronePos, candidateCellContent);
-			float distanceScore = -glm::distance(dronePos, nearestCell->getRelaxedPosition());
-
-			// Calculate the candidate's item score (i.e. how preferred the candidate would be selected based on the amount
-			// of stored items and planned changes to the candidate's inventory).
-			world::Inventory& candidateInventory = registry.get<world::Inventory>(candidate);
-			PlannedInventoryChanges* plannedChanges = nullptr;
-			auto& found = plannedInventoryChanges.find(candidate);
-			if (found != plannedInventoryChanges.end())
-				plannedChanges = &found->second;
-			float itemScore = getItemScore(candidateInventory, plannedChanges);
-			if (itemScore == std::numeric_limits<float>::lowest())
-				return;
-
-			// Check if the current candidate is better than the current best, and update the current best accordingly.
-			float totalScore = distanceScore * world::RESOURCE_MANAGEMENT_CANDIDATE_PLANNING_DISTANCE_WEIGHT
-				+ itemScore * world::RESOURCE_MANAGEMENT_CANDIDATE_PLANNING_ITEMS_WEIGHT;
-			if (totalScore > currentBestScore)
-			{
-				currentBestScore = totalScore;
-				bestMatch = candidateCellContent;
-			}
-		}));
+		auto view = registry.view<ItemInteraction>();
+		for (auto candidate : view)
+			scoreCandidate(currentBestScore, bestMatch, registry, dronePos, getItemScore, candidate);
 	}
 
 	world::CellContent* findPickupCellContent(
 		entt::registry& registry,
 		glm::vec2 dronePos,
 		world::Drone& drone,
-		std::shared_ptr<world::IItem> item,
+		world::IItem* item,
 		bool checkHarvestables
 	) {
-		auto getItemScore = std::function([item](world::Inventory& inventory, PlannedInventoryChanges* plannedChanges) -> float {
+		auto getItemScore = [item](world::Inventory& inventory, PlannedInventoryChanges* plannedChanges) -> float {
 			float stored = inventory.getStoredAmount(item);
 
 			float plannedForPickup = 0.0f;
@@ -252,15 +428,32 @@ namespace game::systems
 				return std::numeric_limits<float>::lowest();
 			else
 				return remainingAmount;
-		});
+		};
 
 		float currentBestScore = std::numeric_limits<float>::lowest();
 		world::CellContent* bestMatch = nullptr;
-		findBestCandidate(currentBestScore, bestMatch, registry, dronePos, item, getItemScore, item->getProduces());
-		findBestCandidate(currentBestScore, bestMatch, registry, dronePos, item, getItemScore, item->getStores());
+		world::visitItemType(item, [&](auto* itemTypeTag) {
+			using ItemType = std::remove_pointer_t<decltype(itemTypeTag)>;
+
+			findBestCandidate<world::Produces<ItemType>>(currentBestScore, bestMatch, registry, dronePos, getItemScore);
+
+			// The item score of a storage can't exceed the amount stored in its region, so regions which are too far away
+			// or store too few items to beat the best candidate are skipped without looking at their storages.
+			size_t itemTypeIndex = item->index;
+			forEachStorageNear(registry, dronePos,
+				[&currentBestScore, itemTypeIndex](const std::array<float, world::AMOUNT_OF_ITEM_TYPES>& storedAmounts, float minDistance) {
+					float maxScore = -minDistance * world::RESOURCE_MANAGEMENT_CANDIDATE_PLANNING_DISTANCE_WEIGHT
+						+ storedAmounts[itemTypeIndex] * world::RESOURCE_MANAGEMENT_CANDIDATE_PLANNING_ITEMS_WEIGHT;
+					return storedAmounts[itemTypeIndex] > 0.0f && maxScore > currentBestScore;
+				},
+				[&](entt::entity storage) {
+					scoreCandidate(currentBestScore, bestMatch, registry, dronePos, getItemScore, storage);
+				}
+			);
 
-		if (checkHarvestables && bestMatch == nullptr)
-			findBestCandidate(currentBestScore, bestMatch, registry, dronePos, item, getItemScore, item->getHarvestable());
+			if (checkHarvestables && bestMatch == nullptr)
+				findBestCandidate<world::Harvestable<ItemType>>(currentBestScore, bestMatch, registry, dronePos, getItemScore);
+		});
 
 		return bestMatch;
 	}
@@ -269,7 +462,7 @@ namespace game::systems
 		entt::registry& registry,
 		world::Cell* startCell,
 		world::Drone& drone,
-		std::shared_ptr<world::IItem> item,
+		world::IItem* item,
 		bool checkHarvestables
 	) {
 		return findPickupCellContent(registry, startCell->getRelaxedPosition(), drone, item, checkHarvestables);
@@ -279,11 +472,10 @@ namespace game::systems
 		entt::registry& registry,
 		entt::entity& entity,
 		world::Drone& drone,
-		std::shared_ptr<world::IItem> item,
+		world::IItem* item,
 		bool checkHarvestables
 	) {
-		auto& droneTransform = registry.get<rendering::components::EulerComponentwiseTransform>(entity);
-		glm::vec2 dronePos = glm::vec2(droneTransform.getTranslation().x, droneTransform.getTranslation().z);
+		glm::vec2 dronePos = getDronePosition(registry, entity);
 
 		return findPickupCellContent(registry, dronePos, drone, item, checkHarvestables);
 	}
@@ -292,9 +484,9 @@ namespace game::systems
 		entt::registry& registry,
 		glm::vec2 dronePos,
 		world::Drone& drone,
-		std::shared_ptr<world::IItem> itemType
+		world::IItem* itemType
 	) {
-		auto getItemScore = std::function([itemType](world::Inventory& inventory, PlannedInventoryChanges* plannedChanges) -> float {
+		auto getItemScore = [itemType](world::Inventory& inventory, PlannedInventoryChanges* plannedChanges) -> float {
 			float stored = inventory.getStoredAmount(itemType);
 
 			float plannedForDelivery = 0.0f;
@@ -305,12 +497,27 @@ namespace game::systems
 			// the planned amount before returning it so that consumers with less stored items will get a greater score.
 			float plannedAmount = stored + plannedForDelivery;
 			return -plannedAmount;
-		});
+		};
 
 		float currentBestScore = std::numeric_limits<float>::lowest();
 		world::CellContent* bestMatch = nullptr;
-		findBestCandidate(currentBestScore, bestMatch, registry, dronePos, itemType, getItemScore, itemType->getConsumes());
-		findBestCandidate(currentBestScore, bestMatch, registry, dronePos, itemType, getItemScore, itemType->getStores());
+		world::visitItemType(itemType, [&](auto* itemTypeTag) {
+			using ItemType = std::remove_pointer_t<decltype(itemTypeTag)>;
+
+			findBestCandidate<world::Consumes<ItemType>>(currentBestScore, bestMatch, registry, dronePos, getItemScore);
+
+			// The item score of a storage is never positive, so only storages which are nearer than the best candidate
+			// can beat it.
+			forEachStorageNear(registry, dronePos,
+				[&currentBestScore](const std::array<float, world::AMOUNT_OF_ITEM_TYPES>& storedAmounts, float minDistance) {
+					return -minDistance * world::RESOURCE_MANAGEMENT_CANDIDATE_PLANNING_DISTANCE_WEIGHT > currentBestScore;
+				},
+				[&](entt::entity storage) {
+					if (registry.has<world::Stores<ItemType>>(storage))
+						scoreCandidate(currentBestScore, bestMatch, registry, dronePos, getItemScore, storage);
+				}
+			);
+		});
 
 		return bestMatch;
 	}
@@ -319,7 +526,7 @@ namespace game::systems
 		entt::registry& registry,
 		world::Cell* startCell,
 		world::Drone& drone,
-		std::shared_ptr<world::IItem> itemType
+		world::IItem* itemType
 	) {
 		return findDeliveryCellContent(registry, startCell->getRelaxedPosition(), drone, itemType);
 	}
@@ -328,203 +535,193 @@ namespace game::systems
 		entt::registry& registry,
 		entt::entity& entity,
 		world::Drone& drone,
-		std::shared_ptr<world::IItem> itemType
+		world::IItem* itemType
 	) {
-		auto& droneTransform = registry.get<rendering::components::EulerComponentwiseTransform>(entity);
-		glm::vec2 dronePos = glm::vec2(droneTransform.getTranslation().x, droneTransform.getTranslation().z);
+		glm::vec2 dronePos = getDronePosition(registry, entity);
 
 		return findDeliveryCellContent(registry, dronePos, drone, itemType);
 	}
 
 	void setDestination(
-		world::DroneTask* task,
+		world::DroneTask& task,
 		world::CellContent* destination,
 		entt::registry& registry,
 		entt::entity& entity
 	) {
 		if (destination != nullptr)
-			task->destination = findNearestCell(registry, entity, destination);
+			task.destination = findNearestCell(registry, entity, destination);
 		else
-			task->destination = nullptr;
-	}
-
-	struct PickupTask : public world::DroneTask
-	{
-		std::shared_ptr<world::IItem> item;
-		bool exact;
-		bool checkHarvestables;
-		PlannedPickup plannedPickup;
-
-		PickupTask(world::Cell* _destination, std::shared_ptr<world::IItem> _item, bool _exact, bool _checkHarvestables)
-			: world::DroneTask(_destination),
-			item(_item),
-			exact(_exact),
-			checkHarvestables(_checkHarvestables),
-			plannedPickup(PlannedPickup(destination->getContent()->getEntity(), item)) {}
-
-		bool checkAndUpdateDestination(
-			entt::registry& registry,
-			entt::entity& entity,
-			world::Drone& drone,
-			world::Inventory& inventory
-		) {
-			if (destination == nullptr || destination->getContent() == nullptr)
-			{
-				// Destination is no longer valid. Find a new destination from which the items can be picked up.
-				plannedPickup.cancel(registry);
-				setDestination(this, findPickupCellContent(registry, entity, drone, item, checkHarvestables), registry, entity);
-				plannedPickup = PlannedPickup(destination->getContent()->getEntity(), item);
-			}
+			task.destination = nullptr;
+	}
 
-			return true;
-		}
+	world::DroneTask createPickupTask(
+		entt::registry& registry,
+		world::Cell* destination,
+		world::IItem* itemType,
+		float amount,
+		bool exact,
+		bool checkHarvestables
+	) {
+		world::DroneTask task;
+		task.type = world::DroneTaskType::PICKUP;
+		task.destination = destination;
+		task.itemType = itemType;
+		task.amount = amount;
+		task.exact = exact;
+		task.checkHarvestables = checkHarvestables;
+		planInventoryChange(registry, task, destination->getContent()->getEntity());
+
+		return task;
+	}
 
-		bool destinationReached(
-			entt::registry& registry,
-			entt::entity& entity,
-			world::Drone& drone,
-			world::Inventory& inventory
-		) {
-			float amountPickedUp = plannedPickup.execute(registry, entity, destination->getContent()->getEntity());
-			if (exact && amountPickedUp != item->amount)
-			{
-				item->amount -= amountPickedUp;
-				destination = nullptr;
-				return false;
-			}
+	world::DroneTask createDeliveryTask(entt::registry& registry, world::Cell* destination, world::IItem* itemType, float amount)
+	{
+		world::DroneTask task;
+		task.type = world::DroneTaskType::DELIVERY;
+		task.destination = destination;
+		task.itemType = itemType;
+		task.amount = amount;
+		planInventoryChange(registry, task, destination->getContent()->getEntity());
+
+		return task;
+	}
 
-			return true;
-		}
+	world::DroneTask createConstructionTask(world::Cell* destination, world::IBuilding* buildingType)
+	{
+		if (destination == nullptr)
+			throw std::logic_error("Construction task created with no destination! This must be a bug in the task planning algorithm...");
 
-		void cancel(entt::registry& registry)
-		{
-			plannedPickup.cancel(registry);
-		}
-	};
+		world::DroneTask task;
+		task.type = world::DroneTaskType::CONSTRUCTION;
+		task.destination = destination;
+		task.buildingType = buildingType;
+
+		return task;
+	}
 
-	struct DeliveryTask : public world::DroneTask
+	world::DroneTask createDestructionTask(world::Cell* destination)
 	{
-		std::shared_ptr<world::IItem> item;
-		PlannedDelivery plannedDelivery;
+		if (destination == nullptr)
+			throw std::logic_error("Destruction task created with no destination! This must be a bug in the task planning algorithm...");
 
-		DeliveryTask(world::Cell* _destination, std::shared_ptr<world::IItem> _item)
-			: world::DroneTask(_destination), item(_item), plannedDelivery(PlannedDelivery(destination->getContent()->getEntity(), item)) {}
+		world::DroneTask task;
+		task.type = world::DroneTaskType::DESTRUCTION;
+		task.destination = destination;
 
-		bool checkAndUpdateDestination(
-			entt::registry& registry,
-			entt::entity& entity,
-			world::Drone& drone,
-			world::Inventory& inventory
-		) {
-			if (inventory.items.empty())
+		return task;
+	}
+
+	// Checks whether the task can still be pursued. As the drones are updated in parallel, this must neither modify the
+	// registry nor any planned inventory changes. If the destination is no longer valid, but there is a suitable
+	// replacement, the replacement is returned via replacementDestination.
+	bool checkTaskDestination(
+		entt::registry& registry,
+		entt::entity& entity,
+		world::Drone& drone,
+		world::Inventory& inventory,
+		world::DroneTask& task,
+		world::CellContent*& replacementDestination
+	) {
+		switch (task.type)
+		{
+		case world::DroneTaskType::PICKUP:
+			if (task.destination == nullptr || task.destination->getContent() == nullptr)
+			{
+				// Destination is no longer valid. Find a new destination from which the items can be picked up.
+				replacementDestination = findPickupCellContent(registry, entity, drone, task.itemType, task.checkHarvestables);
+				return replacementDestination != nullptr;
+			}
+			return true;
+		case world::DroneTaskType::DELIVERY:
+			if (inventory.empty())
 				return false;
 
-			if (destination == nullptr || destination->getContent() == nullptr)
+			if (task.destination == nullptr || task.destination->getContent() == nullptr)
 			{
 				// Destination is no longer valid. Find a new destination where the items can be delivered at.
-				plannedDelivery.cancel(registry);
-				setDestination(this, findDeliveryCellContent(registry, entity, drone, item), registry, entity);
-				plannedDelivery = PlannedDelivery(destination->getContent()->getEntity(), item);
+				replacementDestination = findDeliveryCellContent(registry, entity, drone, task.itemType);
+				return replacementDestination != nullptr;
 			}
-
 			return true;
+		case world::DroneTaskType::CONSTRUCTION:
+			return task.buildingType->canBePlacedOnCell(task.destination);
+		case world::DroneTaskType::DESTRUCTION:
+			return task.destination->getContent() != nullptr;
+		default:
+			return false;
 		}
+	}
 
-		bool destinationReached(
-			entt::registry& registry,
-			entt::entity& entity,
-			world::Drone& drone,
-			world::Inventory& inventory
-		) {
-			plannedDelivery.execute(registry, entity, destination->getContent()->getEntity());
-			return true;
-		}
+	// Replaces the task's destination with the replacement found by checkTaskDestination. This is called sequentially.
+	void replaceTaskDestination(
+		entt::registry& registry,
+		entt::entity& entity,
+		world::DroneTask& task,
+		world::CellContent* replacementDestination
+	) {
+		cancelPlannedInventoryChange(registry, task);
+		setDestination(task, replacementDestination, registry, entity);
+		planInventoryChange(registry, task, task.destination->getContent()->getEntity());
+	}
 
-		void cancel(entt::registry& registry)
+	// Performs the task's action. Returns false if the task is not yet finished.
+	bool taskDestinationReached(
+		entt::registry& registry,
+		entt::entity& entity,
+		world::Drone& drone,
+		world::Inventory& inventory,
+		world::DroneTask& task
+	) {
+		switch (task.type)
 		{
-			plannedDelivery.cancel(registry);
-		}
-	};
-
-	struct ConstructionTask : public world::DroneTask
-	{
-		world::IBuilding* buildingType;
-
-		ConstructionTask(world::Cell* _destination, world::IBuilding* _buildingType) : world::DroneTask(_destination), buildingType(_buildingType)
+		case world::DroneTaskType::PICKUP:
 		{
-			if (destination == nullptr)
-				throw std::logic_error("ConstructionTask created with no destination! This must be a bug in the task planning algorithm...");
-		}
-
-		bool checkAndUpdateDestination(
-			entt::registry& registry,
-			entt::entity& entity,
-			world::Drone& drone,
-			world::Inventory& inventory
-		) {
-			return buildingType->canBePlacedOnCell(destination);
+			float amountPickedUp = executePlannedInventoryChange(registry, entity, task, task.destination->getContent()->getEntity());
+			if (task.exact && amountPickedUp != task.amount)
+			{
+				task.amount -= amountPickedUp;
+				task.destination = nullptr;
+				return false;
+			}
+			return true;
 		}
-
-		bool destinationReached(
-			entt::registry& registry,
-			entt::entity& entity,
-			world::Drone& drone,
-			world::Inventory& inventory
-		) {
-			if (buildingType->placeBuildingOfThisTypeOnCell(destination))
+		case world::DroneTaskType::DELIVERY:
+			executePlannedInventoryChange(registry, entity, task, task.destination->getContent()->getEntity());
+			return true;
+		case world::DroneTaskType::CONSTRUCTION:
+			if (task.buildingType->placeBuildingOfThisTypeOnCell(task.destination))
 			{
-				for (std::shared_ptr<world::IItem> item : buildingType->getResourcesRequiredToBuild().items)
-					inventory.removeItem(item, item->amount);
+				task.buildingType->getResourcesRequiredToBuild().forEachItem([&inventory](world::IItem* itemType, float amount) {
+					inventory.removeItem(itemType, amount);
+				});
 				drone.inventoryUpdated(registry, entity, inventory);
 			}
-
 			return true;
-		}
-	};
-
-	struct DestructionTask : public world::DroneTask
-	{
-		DestructionTask(world::Cell* _destination) : world::DroneTask(_destination)
+		case world::DroneTaskType::DESTRUCTION:
 		{
-			if (destination == nullptr)
-				throw std::logic_error("DestructionTask created with no destination! This must be a bug in the task planning algorithm...");
-		}
-
-		bool checkAndUpdateDestination(
-			entt::registry& registry,
-			entt::entity& entity,
-			world::Drone& drone,
-			world::Inventory& inventory
-		) {
-			return destination->getContent() != nullptr;
-		}
-
-		bool destinationReached(
-			entt::registry& registry,
-			entt::entity& entity,
-			world::Drone& drone,
-			world::Inventory& inventory
-		) {
-			world::CellContent* destinationContent = destination->getContent();
-			inventory.addItems(destinationContent->getResourcesObtainedByRemoval(destination));
+			world::CellContent* destinationContent = task.destination->getContent();
+			inventory.addItems(destinationContent->getResourcesObtainedByRemoval(task.destination));
 
 			destinationContent->inventoryUpdated();
 			drone.inventoryUpdated(registry, entity, inventory);
 
-			destination->setContent(nullptr);
-
+			task.destination->setContent(nullptr);
 			return true;
 		}
-	};
+		default:
+			return true;
+		}
+	}
 
 	float calculateAmountToPickup(
 		entt::registry& registry,
 		world::CellContent* sourceCellContent,
-		std::shared_ptr<world::IItem> itemType,
+		world::IItem* itemType,
 		float maxAmountToPickup
 	) {
 		float stored = registry.get<world::Inventory>(sourceCellContent->getEntity()).getStoredAmount(itemType);
 
+		auto& plannedInventoryChanges = getResourceProcessingContext(registry).plannedInventoryChanges;
 		float plannedForPickup = 0.0f;
 		auto& found = plannedInventoryChanges.find(sourceCellContent->getEntity());
 		if (found != plannedInventoryChanges.end())
@@ -534,11 +731,181 @@ namespace game::systems
 		return std::min(availableAmount, maxAmountToPickup);
 	}
 
-	void schedulePickupAndDeliveryTask(
+	// Calculates the length of a route starting at the given position if the given pickup and delivery were inserted in
+	// front of the stops at pickupIndex and deliveryIndex. Returns the maximum float value if the drone's carry capacity
+	// would be exceeded at any of the route's stops, starting with the given amount of items already carried by the drone.
+	float evaluateRouteInsertion(
+		const std::vector<world::DroneTask>& routeStops,
+		glm::vec2 start,
+		float initialLoad,
+		const world::DroneTask& pickup,
+		const world::DroneTask& delivery,
+		size_t pickupIndex,
+		size_t deliveryIndex
+	) {
+		float length = 0.0f;
+		float load = initialLoad;
+		glm::vec2 position = start;
+
+		auto visit = [&length, &load, &position](const world::DroneTask& stop) {
+			glm::vec2 stopPosition = stop.destination->getRelaxedPosition();
+			length += glm::distance(position, stopPosition);
+			position = stopPosition;
+
+			load += stop.type == world::DroneTaskType::PICKUP ? stop.amount : -stop.amount;
+			return load <= world::RESOURCE_MANAGEMENT_DRONE_CARRY_CAPACITY;
+		};
+
+		for (size_t i = 0; i <= routeStops.size(); i++)
+		{
+			if (i == pickupIndex && !visit(pickup))
+				return std::numeric_limits<float>::max();
+			if (i == deliveryIndex && !visit(delivery))
+				return std::numeric_limits<float>::max();
+			if (i < routeStops.size() && !visit(routeStops[i]))
+				return std::numeric_limits<float>::max();
+		}
+
+		return length;
+	}
+
+	// Tries to insert a transport of items from the source to the destination into the current route. The transport is
+	// inserted at the position which increases the length of the route the least. It is only inserted if the increase is
+	// shorter than flying the transport as a separate trip from the route's start.
+	bool tryInsertIntoRoute(
+		entt::registry& registry,
+		glm::vec2 start,
+		float initialLoad,
+		world::IItem* itemType,
+		world::CellContent* sourceCellContent,
+		world::CellContent* destinationCellContent
+	) {
+		if (sourceCellContent == destinationCellContent)
+			return false;
+
+		float amountToPickup = calculateAmountToPickup(
+			registry,
+			sourceCellContent,
+			itemType,
+			world::RESOURCE_MANAGEMENT_DEFAULT_TRANSPORT_CAPACITY
+		);
+		if (amountToPickup <= 0.0f)
+			return false;
+
+		// The tasks are only created (and thereby registered as planned inventory changes) once the best insertion is known.
+		world::DroneTask pickup;
+		pickup.type = world::DroneTaskType::PICKUP;
+		pickup.destination = findNearestCell(start, sourceCellContent);
+		pickup.amount = amountToPickup;
+
+		world::DroneTask delivery;
+		delivery.type = world::DroneTaskType::DELIVERY;
+		delivery.destination = findNearestCell(pickup.destination, destinationCellContent);
+		delivery.amount = amountToPickup;
+
+		std::vector<world::DroneTask>& routeStops = getResourceProcessingContext(registry).routeStops;
+		float currentLength = evaluateRouteInsertion(routeStops, start, initialLoad, pickup, delivery, routeStops.size() + 1, routeStops.size() + 1);
+		float bestLength = std::numeric_limits<float>::max();
+		size_t bestPickupIndex = 0;
+		size_t bestDeliveryIndex = 0;
+		for (size_t pickupIndex = 0; pickupIndex <= routeStops.size(); pickupIndex++)
+		{
+			for (size_t deliveryIndex = pickupIndex; deliveryIndex <= routeStops.size(); deliveryIndex++)
+			{
+				float length = evaluateRouteInsertion(routeStops, start, initialLoad, pickup, delivery, pickupIndex, deliveryIndex);
+				if (length < bestLength)
+				{
+					bestLength = length;
+					bestPickupIndex = pickupIndex;
+					bestDeliveryIndex = deliveryIndex;
+				}
+			}
+		}
+
+		glm::vec2 pickupPosition = pickup.destination->getRelaxedPosition();
+		float separateTripLength = glm::distance(start, pickupPosition)
+			+ glm::distance(pickupPosition, delivery.destination->getRelaxedPosition());
+		if (bestLength == std::numeric_limits<float>::max() || bestLength - currentLength >= separateTripLength)
+			return false;
+
+		// Insert the delivery first, so that the pickup index remains valid.
+		routeStops.insert(routeStops.begin() + bestDeliveryIndex,
+			createDeliveryTask(registry, delivery.destination, itemType, amountToPickup));
+		routeStops.insert(routeStops.begin() + bestPickupIndex,
+			createPickupTask(registry, pickup.destination, itemType, amountToPickup, false, false));
+
+		return true;
+	}
+
+	// Extends the current route with the transports of filled producers and starving consumers which lie along the route.
+	// To keep the amount of work per decision bounded, only a limited amount of candidates is considered. Candidates which
+	// weren't inserted are put back into their queue.
+	void extendRoute(entt::registry& registry, glm::vec2 start, float initialLoad, world::Drone& drone)
+	{
+		auto& context = getResourceProcessingContext(registry);
+		auto& routeStops = context.routeStops;
+		auto& filledProducers = context.filledProducers;
+		auto& starvingConsumers = context.starvingConsumers;
+
+		std::array<EntityAmount, world::RESOURCE_MANAGEMENT_ROUTE_MAX_CANDIDATES> rejectedProducers;
+		std::array<EntityAmount, world::RESOURCE_MANAGEMENT_ROUTE_MAX_CANDIDATES> rejectedConsumers;
+		size_t amountOfRejectedProducers = 0;
+		size_t amountOfRejectedConsumers = 0;
+
+		for (size_t candidate = 0; candidate < world::RESOURCE_MANAGEMENT_ROUTE_MAX_CANDIDATES; candidate++)
+		{
+			// Each transport needs two slots in the drone's task queue.
+			if (routeStops.size() + 2 > drone.tasks.freeCapacity())
+				break;
+
+			// Alternate between consumers and producers, preferring consumers as they are more urgent.
+			EntityAmount entityAmount;
+			bool consumer = candidate % 2 == 0 || filledProducers.empty();
+			if (consumer && popEntityAmount(registry, starvingConsumers, true, entityAmount))
+			{
+				world::CellContent* destinationCellContent = registry.get<world::CellContentComponent>(entityAmount.entity).cellContent;
+				glm::vec2 destinationPosition = findNearestCell(start, destinationCellContent)->getRelaxedPosition();
+				world::CellContent* sourceCellContent = findPickupCellContent(registry, destinationPosition, drone, entityAmount.itemType, false);
+				if (sourceCellContent == nullptr
+					|| !tryInsertIntoRoute(registry, start, initialLoad, entityAmount.itemType, sourceCellContent, destinationCellContent))
+					rejectedConsumers[amountOfRejectedConsumers++] = entityAmount;
+			}
+			else if (popEntityAmount(registry, filledProducers, false, entityAmount))
+			{
+				world::CellContent* sourceCellContent = registry.get<world::CellContentComponent>(entityAmount.entity).cellContent;
+				glm::vec2 sourcePosition = findNearestCell(start, sourceCellContent)->getRelaxedPosition();
+				world::CellContent* destinationCellContent = findDeliveryCellContent(registry, sourcePosition, drone, entityAmount.itemType);
+				if (destinationCellContent == nullptr
+					|| !tryInsertIntoRoute(registry, start, initialLoad, entityAmount.itemType, sourceCellContent, destinationCellContent))
+					rejectedProducers[amountOfRejectedProducers++] = entityAmount;
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		for (size_t i = 0; i < amountOfRejectedConsumers; i++)
+			pushEntityAmount(context, starvingConsumers, rejectedConsumers[i], true);
+		for (size_t i = 0; i < amountOfRejectedProducers; i++)
+			pushEntityAmount(context, filledProducers, rejectedProducers[i], false);
+	}
+
+	// The capacity of the drone's task queue is checked while planning. A failing push would silently drop a task whose
+	// inventory change was already planned, so it is treated as a bug.
+	void pushTask(world::DroneTaskQueue& tasks, const world::DroneTask& task)
+	{
+		if (!tasks.push(task))
+			throw std::logic_error("Drone task queue is full! This must be a bug in the task planning algorithm...");
+	}
+
+	// Schedules the transport of items from the source to the destination. If the drone has spare capacity, further
+	// transports along the way are batched into the same trip. Returns false if there are no items left to transport.
+	bool schedulePickupAndDeliveryTask(
 		entt::registry& registry,
 		entt::entity& entity,
 		world::Drone& drone,
-		std::shared_ptr<world::IItem> itemType,
+		world::IItem* itemType,
 		world::CellContent* sourceCellContent,
 		world::CellContent* destinationCellContent
 	) {
@@ -548,53 +915,91 @@ namespace game::systems
 			itemType,
 			world::RESOURCE_MANAGEMENT_DEFAULT_TRANSPORT_CAPACITY
 		);
+		if (amountToPickup <= 0.0f)
+			return false;
+
+		float initialLoad = 0.0f;
+		registry.get<world::Inventory>(entity).forEachItem([&initialLoad](world::IItem* itemType, float amount) {
+			initialLoad += amount;
+		});
+
+		glm::vec2 start = getDronePosition(registry, entity);
+		world::Cell* pickupCell = findNearestCell(start, sourceCellContent);
+
+		std::vector<world::DroneTask>& routeStops = getResourceProcessingContext(registry).routeStops;
+		routeStops.clear();
+		routeStops.push_back(createPickupTask(registry, pickupCell, itemType, amountToPickup, false, false));
+		routeStops.push_back(createDeliveryTask(registry, findNearestCell(pickupCell, destinationCellContent), itemType, amountToPickup));
+
+		extendRoute(registry, start, initialLoad, drone);
+
+		for (world::DroneTask& task : routeStops)
+			pushTask(drone.tasks, task);
+		routeStops.clear();
+
+		return true;
+	}
 
-		std::shared_ptr<world::IItem> itemAndAmount = itemType->clone(amountToPickup);
-		world::Cell* pickupCell = findNearestCell(registry, entity, sourceCellContent);
-		drone.tasks.push(new PickupTask(pickupCell, itemAndAmount, false, false));
-		drone.tasks.push(new DeliveryTask(findNearestCell(pickupCell, destinationCellContent), itemAndAmount));
+	void cancelTasks(entt::registry& registry, world::DroneTaskQueue& tasks)
+	{
+		while (!tasks.empty())
+		{
+			cancelPlannedInventoryChange(registry, tasks.front());
+			tasks.pop();
+		}
 	}
 
+	// Tries to schedule the given construction order. If the order needs more pickups than fit into the drone's task queue,
+	// only the first pickups are scheduled and the remaining ones are scheduled once the drone arrives at the construction
+	// site. If this fails because some required item isn't available anywhere, that item type is returned via missingItem.
 	bool tryScheduleConstructionTask(
 		entt::registry& registry,
 		entt::entity& entity,
 		world::Drone& drone,
-		std::pair<world::Cell*, world::IBuilding*>& cellAndBuilding
+		ConstructionOrder& order,
+		world::IItem*& missingItem
 	) {
-		std::vector<PickupTask*> pickupTasks;
+		// The construction task itself needs a slot in the drone's task queue as well.
+		if (drone.tasks.full())
+			return false;
+		size_t maxAmountOfPickups = drone.tasks.freeCapacity() - 1;
+
+		world::DroneTaskQueue pickupTasks;
 		world::Cell* lastCell = nullptr;
-		for (std::shared_ptr<world::IItem> item : cellAndBuilding.second->getResourcesRequiredToBuild().items)
+		const world::Inventory& requiredResources = order.buildingType->getResourcesRequiredToBuild();
+		for (size_t itemTypeIndex = 0; itemTypeIndex < world::AMOUNT_OF_ITEM_TYPES; itemTypeIndex++)
 		{
-			float remainingAmountToPickup = item->amount - registry.get<world::Inventory>(entity).getStoredAmount(item);
-			while (remainingAmountToPickup > 0.0f)
+			world::IItem* item = world::getItemType(itemTypeIndex);
+			float remainingAmountToPickup = requiredResources.amounts[itemTypeIndex] - registry.get<world::Inventory>(entity).getStoredAmount(item);
+			while (remainingAmountToPickup > 0.0f && pickupTasks.size() < maxAmountOfPickups)
 			{
 				world::CellContent* sourceCellContent = lastCell == nullptr 
 					? findPickupCellContent(registry, entity, drone, item, true)
 					: findPickupCellContent(registry, lastCell, drone, item, true);
+
 				if (sourceCellContent == nullptr)
 				{
-					for (PickupTask* pickupTask : pickupTasks)
-					{
-						pickupTask->cancel(registry);
-						delete pickupTask;
-					}
+					missingItem = item;
+					cancelTasks(registry, pickupTasks);
 					return false;
 				}
 
 				float amountToPickup = calculateAmountToPickup(registry, sourceCellContent, item, remainingAmountToPickup);
 				remainingAmountToPickup -= amountToPickup;
-				std::shared_ptr<world::IItem> itemAndAmount = item->clone(amountToPickup);
 
 				lastCell = lastCell == nullptr
 					? findNearestCell(registry, entity, sourceCellContent)
 					: findNearestCell(lastCell, sourceCellContent);
-				pickupTasks.push_back(new PickupTask(lastCell, itemAndAmount, true, true));
+				pushTask(pickupTasks, createPickupTask(registry, lastCell, item, amountToPickup, true, true));
 			}
 		}
 
-		for (PickupTask* pickupTask : pickupTasks)
-			drone.tasks.push(pickupTask);
-		drone.tasks.push(new ConstructionTask(cellAndBuilding.first, cellAndBuilding.second));
+		while (!pickupTasks.empty())
+		{
+			pushTask(drone.tasks, pickupTasks.front());
+			pickupTasks.pop();
+		}
+		pushTask(drone.tasks, createConstructionTask(order.cell, order.buildingType));
 
 		return true;
 	}
@@ -604,40 +1009,50 @@ namespace game::systems
 		world::CellContent* destinationContent = cell->getContent();
 		world::Inventory resourcesObtainedByRemoval = destinationContent->getResourcesObtainedByRemoval(cell);
 
-		std::vector<DeliveryTask*> deliveryTasks;
+		world::DroneTaskQueue deliveryTasks;
 		world::Cell* lastCell = cell;
-		for (std::shared_ptr<world::IItem> item : resourcesObtainedByRemoval.items)
+		for (size_t itemTypeIndex = 0; itemTypeIndex < world::AMOUNT_OF_ITEM_TYPES; itemTypeIndex++)
 		{
+			float amount = resourcesObtainedByRemoval.amounts[itemTypeIndex];
+			if (amount == 0.0f)
+				continue;
+
+			world::IItem* item = world::getItemType(itemTypeIndex);
+			// The destruction task itself needs a slot in the drone's task queue as well.
 			world::CellContent* destinationCellContent = findDeliveryCellContent(registry, lastCell, drone, item);
-			if (destinationCellContent == nullptr)
+			if (destinationCellContent == nullptr || deliveryTasks.size() + 1 >= drone.tasks.freeCapacity())
 			{
-				for (DeliveryTask* deliveryTask : deliveryTasks)
-				{
-					deliveryTask->cancel(registry);
-					delete deliveryTask;
-				}
+				cancelTasks(registry, deliveryTasks);
 				return false;
-
-				lastCell = findNearestCell(lastCell, destinationCellContent);
-				deliveryTasks.push_back(new DeliveryTask(lastCell, item));
 			}
+
+			lastCell = findNearestCell(lastCell, destinationCellContent);
+			pushTask(deliveryTasks, createDeliveryTask(registry, lastCell, item, amount));
 		}
 
-		drone.tasks.push(new DestructionTask(cell));
-		for (DeliveryTask* deliveryTask : deliveryTasks)
-			drone.tasks.push(deliveryTask);
+		pushTask(drone.tasks, createDestructionTask(cell));
+		while (!deliveryTasks.empty())
+		{
+			pushTask(drone.tasks, deliveryTasks.front());
+			deliveryTasks.pop();
+		}
 
 		return true;
 	}
 
 	bool tryFindTaskToEmptyInventory(entt::registry& registry, entt::entity& entity, world::Drone& drone, world::Inventory& inventory)
 	{
-		for (std::shared_ptr<world::IItem> item : inventory.items)
+		for (size_t itemTypeIndex = 0; itemTypeIndex < world::AMOUNT_OF_ITEM_TYPES; itemTypeIndex++)
 		{
+			float amount = inventory.amounts[itemTypeIndex];
+			if (amount == 0.0f)
+				continue;
+
+			world::IItem* item = world::getItemType(itemTypeIndex);
 			world::CellContent* destinationCellContent = findDeliveryCellContent(registry, entity, drone, item);
 			if (destinationCellContent != nullptr)
 			{
-				drone.tasks.push(new DeliveryTask(findNearestCell(registry, entity, destinationCellContent), item));
+				pushTask(drone.tasks, createDeliveryTask(registry, findNearestCell(registry, entity, destinationCellContent), item, amount));
 				return true;
 			}
 		}
@@ -645,53 +1060,229 @@ namespace game::systems
 		return false;
 	}
 
+	// At most RESOURCE_MANAGEMENT_TRANSPORT_MAX_ATTEMPTS queued consumers (or producers) are tried per drone and update, as
+	// each attempt searches for a source (or destination) of the items. Once no source (or destination) was found for an
+	// item type, the remaining attempts don't search for that item type again.
 	bool tryFindTaskForStarvingConsumer(entt::registry& registry, entt::entity& entity, world::Drone& drone)
 	{
-		while (!starvingConsumers.empty())
+		auto& starvingConsumers = getResourceProcessingContext(registry).starvingConsumers;
+		std::array<bool, world::AMOUNT_OF_ITEM_TYPES> itemTypeUnavailable{};
+		EntityAmount consumer;
+		for (size_t attempts = 0; attempts < world::RESOURCE_MANAGEMENT_TRANSPORT_MAX_ATTEMPTS
+			&& popEntityAmount(registry, starvingConsumers, true, consumer); attempts++)
 		{
-			EntityAmount consumer = starvingConsumers.top();
-			starvingConsumers.pop();
+			world::CellContent* sourceCellContent = nullptr;
+			if (!itemTypeUnavailable[consumer.itemType->index])
+				sourceCellContent = findPickupCellContent(registry, entity, drone, consumer.itemType, false);
 
-			world::CellContent* sourceCellContent = findPickupCellContent(registry, entity, drone, consumer.itemType, false);
 			if (sourceCellContent != nullptr)
 			{
 				world::CellContent* destinationCellContent = registry.get<world::CellContentComponent>(consumer.entity).cellContent;
-				schedulePickupAndDeliveryTask(registry, entity, drone, consumer.itemType, sourceCellContent, destinationCellContent);
+				if (schedulePickupAndDeliveryTask(registry, entity, drone, consumer.itemType, sourceCellContent, destinationCellContent))
+					return true;
+			}
+			else
+			{
+				itemTypeUnavailable[consumer.itemType->index] = true;
+			}
+
+			// Try again during the next update, as the items may become available in the meantime.
+			markInventoryChanged(registry, consumer.entity);
+		}
+
+		return false;
+	}
+
+	glm::ivec2 getConstructionRegion(glm::vec2 position)
+	{
+		return glm::ivec2(glm::floor(position / world::CONSTRUCTION_BACKLOG_REGION_SIZE));
+	}
+
+	int64_t getConstructionRegionKey(glm::ivec2 region)
+	{
+		return (int64_t(region.x) << 32) | uint32_t(region.y);
+	}
+
+	void addToConstructionBacklog(ResourceProcessingContext& context, const ConstructionOrder& order)
+	{
+		glm::ivec2 region = getConstructionRegion(order.cell->getRelaxedPosition());
+		if (context.amountOfOrdersInConstructionBacklog == 0)
+		{
+			context.minConstructionRegion = region;
+			context.maxConstructionRegion = region;
+		}
+		else
+		{
+			context.minConstructionRegion = glm::min(context.minConstructionRegion, region);
+			context.maxConstructionRegion = glm::max(context.maxConstructionRegion, region);
+		}
+
+		context.constructionBacklog[getConstructionRegionKey(region)].push_back(order);
+		context.amountOfOrdersInConstructionBacklog++;
+	}
+
+	// Tries the orders of the given region in the order in which they were enqueued. Returns true if a construction task
+	// was scheduled. Orders which can't be placed anymore are dropped, and orders which lack items are moved out of the
+	// backlog until the items become available.
+	bool tryScheduleConstructionTaskInRegion(
+		entt::registry& registry,
+		entt::entity& entity,
+		world::Drone& drone,
+		std::vector<ConstructionOrder>& orders,
+		size_t& attempts
+	) {
+		auto& context = getResourceProcessingContext(registry);
+		for (size_t i = 0; i < orders.size() && attempts < world::CONSTRUCTION_BACKLOG_MAX_ATTEMPTS;)
+		{
+			ConstructionOrder order = orders[i];
+			if (!order.buildingType->canBePlacedOnCell(order.cell))
+			{
+				orders.erase(orders.begin() + i);
+				context.amountOfOrdersInConstructionBacklog--;
+				continue;
+			}
+
+			attempts++;
+			world::IItem* missingItem = nullptr;
+			if (tryScheduleConstructionTask(registry, entity, drone, order, missingItem))
+			{
+				orders.erase(orders.begin() + i);
+				context.amountOfOrdersInConstructionBacklog--;
 				return true;
 			}
+
+			if (missingItem != nullptr)
+			{
+				context.ordersWaitingForItems[missingItem->index].push_back(order);
+				orders.erase(orders.begin() + i);
+				context.amountOfOrdersInConstructionBacklog--;
+				continue;
+			}
+
+			i++;
 		}
 
 		return false;
 	}
 
+	bool hasResourcesToBuild(const world::Inventory& inventory, world::IBuilding* buildingType)
+	{
+		const world::Inventory& requiredResources = buildingType->getResourcesRequiredToBuild();
+		for (size_t itemTypeIndex = 0; itemTypeIndex < world::AMOUNT_OF_ITEM_TYPES; itemTypeIndex++)
+			if (inventory.amounts[itemTypeIndex] < requiredResources.amounts[itemTypeIndex])
+				return false;
+		return true;
+	}
+
+	// Called when a drone arrives at a construction site without all required items, i.e. when the order needed more
+	// pickups than fit into the drone's task queue. The remaining items are picked up during another trip. The drone keeps
+	// the items it already carries, as the new tasks are scheduled before the current construction task is removed.
+	void continueConstructionOrder(entt::registry& registry, entt::entity& entity, world::Drone& drone, world::DroneTask& task)
+	{
+		auto& context = getResourceProcessingContext(registry);
+		ConstructionOrder order{ task.destination, task.buildingType };
+
+		world::IItem* missingItem = nullptr;
+		if (tryScheduleConstructionTask(registry, entity, drone, order, missingItem))
+			return;
+
+		if (missingItem != nullptr)
+			context.ordersWaitingForItems[missingItem->index].push_back(order);
+		else
+			addToConstructionBacklog(context, order);
+	}
+
+	// Searches the backlog in rings of regions of increasing distance around the drone, so that the drone picks up orders
+	// near it first. At most CONSTRUCTION_BACKLOG_MAX_ATTEMPTS orders are tried, as each attempt searches for the sources
+	// of all required items.
 	bool tryFindConstructionTask(entt::registry& registry, entt::entity& entity, world::Drone& drone)
 	{
-		bool constructionTaskScheduled = false;
-		std::vector<std::pair<world::Cell*, world::IBuilding*>> buildingsToReenqueue;
+		auto& context = getResourceProcessingContext(registry);
+		if (context.amountOfOrdersInConstructionBacklog == 0)
+			return false;
+
+		glm::ivec2 center = getConstructionRegion(getDronePosition(registry, entity));
+		int maxRing = std::max({
+			std::abs(center.x - context.minConstructionRegion.x), std::abs(center.x - context.maxConstructionRegion.x),
+			std::abs(center.y - context.minConstructionRegion.y), std::abs(center.y - context.maxConstructionRegion.y)
+		});
 
-		while (!buildingsToPlace.empty())
+		size_t attempts = 0;
+		for (int ring = 0; ring <= maxRing && attempts < world::CONSTRUCTION_BACKLOG_MAX_ATTEMPTS; ring++)
 		{
-			std::pair<world::Cell*, world::IBuilding*> cellAndBuilding = buildingsToPlace.front();
-			buildingsToPlace.pop();
-
-			if (cellAndBuilding.second->canBePlacedOnCell(cellAndBuilding.first))
+			for (int x = center.x - ring; x <= center.x + ring; x++)
 			{
-				constructionTaskScheduled = tryScheduleConstructionTask(registry, entity, drone, cellAndBuilding);
-				if (constructionTaskScheduled)
-					break;
-				else
-					buildingsToReenqueue.push_back(cellAndBuilding);
+				for (int y = center.y - ring; y <= center.y + ring; y++)
+				{
+					if (std::abs(x - center.x) != ring && std::abs(y - center.y) != ring)
+						continue;
+
+					auto found = context.constructionBacklog.find(getConstructionRegionKey(glm::ivec2(x, y)));
+					if (found == context.constructionBacklog.end())
+						continue;
+
+					bool scheduled = tryScheduleConstructionTaskInRegion(registry, entity, drone, found->second, attempts);
+					if (found->second.empty())
+						context.constructionBacklog.erase(found);
+
+					if (scheduled)
+						return true;
+					if (attempts >= world::CONSTRUCTION_BACKLOG_MAX_ATTEMPTS || context.amountOfOrdersInConstructionBacklog == 0)
+						return false;
+				}
 			}
 		}
 
-		for (std::pair<world::Cell*, world::IBuilding*>& cellAndBuilding : buildingsToReenqueue)
-			buildingsToPlace.push(cellAndBuilding);
-		
-		return constructionTaskScheduled;
+		return false;
+	}
+
+	// Items are only available if some of them aren't reserved by planned pickups yet. Otherwise, the waiting orders would
+	// be woken up, tried and parked again on every update until the reserved items are picked up.
+	template <class ItemType>
+	bool isItemAvailableForPickup(entt::registry& registry)
+	{
+		world::IItem* itemType = ItemType::getTypeRepresentative();
+		auto isAvailable = [&registry, itemType](entt::entity entity) {
+			return getPlannedAmount(registry, entity, itemType, false) > 0.0f;
+		};
+
+		if (getTotalStoredAmount(registry, itemType) > 0.0f)
+			for (auto& storageAndIndexed : findWarehouseIndex(registry)->indexedStorages)
+				if (isAvailable(storageAndIndexed.first))
+					return true;
+
+		for (auto harvestable : registry.view<world::Harvestable<ItemType>>())
+			if (isAvailable(harvestable))
+				return true;
+
+		for (auto producer : registry.view<world::Produces<ItemType>>())
+			if (isAvailable(producer))
+				return true;
+
+		return false;
+	}
+
+	// Returns construction orders to the backlog once the items they are waiting for are available. This is checked once
+	// per update for each item type with waiting orders instead of once per order and drone.
+	void wakeConstructionOrdersWaitingForItems(entt::registry& registry)
+	{
+		auto& context = getResourceProcessingContext(registry);
+		world::forEachItemType([&registry, &context](auto* itemTypeTag) {
+			using ItemType = std::remove_pointer_t<decltype(itemTypeTag)>;
+
+			auto& waitingOrders = context.ordersWaitingForItems[world::itemTypeIndex<ItemType>];
+			if (waitingOrders.empty() || !isItemAvailableForPickup<ItemType>(registry))
+				return;
+
+			for (ConstructionOrder& order : waitingOrders)
+				addToConstructionBacklog(context, order);
+			waitingOrders.clear();
+		});
 	}
 
 	bool tryFindDestructionTask(entt::registry& registry, entt::entity& entity, world::Drone& drone)
 	{
+		auto& buildingsToRemove = getResourceProcessingContext(registry).buildingsToRemove;
 		bool destructionTaskScheduled = false;
 		std::vector<world::Cell*> cellsToReenqueue;
 
@@ -713,24 +1304,34 @@ namespace game::systems
 		for (world::Cell* cell : cellsToReenqueue)
 			buildingsToRemove.push(cell);
 
-		return false;
+		return destructionTaskScheduled;
 	}
 
 	bool tryFindTaskForFilledProducer(entt::registry& registry, entt::entity& entity, world::Drone& drone)
 	{
-		while (!filledProducers.empty())
+		auto& filledProducers = getResourceProcessingContext(registry).filledProducers;
+		std::array<bool, world::AMOUNT_OF_ITEM_TYPES> itemTypeUndeliverable{};
+		EntityAmount producer;
+		for (size_t attempts = 0; attempts < world::RESOURCE_MANAGEMENT_TRANSPORT_MAX_ATTEMPTS
+			&& popEntityAmount(registry, filledProducers, false, producer); attempts++)
 		{
-			EntityAmount producer = filledProducers.top();
-			filledProducers.pop();
+			world::CellContent* destinationCellContent = nullptr;
+			if (!itemTypeUndeliverable[producer.itemType->index])
+				destinationCellContent = findDeliveryCellContent(registry, entity, drone, producer.itemType);
 
-			world::CellContent* destinationCellContent = findDeliveryCellContent(registry, entity, drone, producer.itemType);
 			if (destinationCellContent != nullptr)
 			{
 				world::CellContent* sourceCellContent = registry.get<world::CellContentComponent>(producer.entity).cellContent;
-				schedulePickupAndDeliveryTask(registry, entity, drone, producer.itemType, sourceCellContent, destinationCellContent);
-
-				return true;
+				if (schedulePickupAndDeliveryTask(registry, entity, drone, producer.itemType, sourceCellContent, destinationCellContent))
+					return true;
 			}
+			else
+			{
+				itemTypeUndeliverable[producer.itemType->index] = true;
+			}
+
+			// Try again during the next update, as storage space may become available in the meantime.
+			markInventoryChanged(registry, producer.entity);
 		}
 
 		return false;
@@ -752,166 +1353,481 @@ namespace game::systems
 		tryFindTaskForFilledProducer(registry, entity, drone);
 	}
 
-	void pursueTask(
+	// The drones are updated in two phases. During the parallel phase, each drone checks whether its current task is still
+	// valid, searches for replacement destinations and starts flying towards its next destination. As the registry and the
+	// planned inventory changes are shared by all drones, this phase only reads from them (except for the drone component
+	// of the drone itself) and records everything else as a command. The commands are then applied sequentially during
+	// the commit phase.
+	// Drones which are flying towards their destination are not updated at all. Their arrival is scheduled as an event
+	// which wakes the drone up once the simulation time reaches its arrival time. Therefore, the validity of a task is only
+	// checked before departing and after arriving at the task's destination.
+	enum class DroneCommandType
+	{
+		NONE,
+		FIND_TASK,
+		EMPTY_INVENTORY,
+		REPLACE_DESTINATION,
+		DROP_TASK,
+		DEPART,
+		DESTINATION_REACHED
+	};
+
+	struct DroneCommand
+	{
+		DroneCommandType type{ DroneCommandType::NONE };
+		world::CellContent* cellContent{ nullptr };
+		world::IItem* item{ nullptr };
+		// The planned amount of items of the destination (see getPlannedAmount) the destination was chosen with.
+		float plannedAmount{ 0.0f };
+		float spotLightIntensity{ 0.0f };
+	};
+
+	// Tag for drones which are currently flying towards their destination.
+	struct DroneInFlight {};
+
+	void prepareDroneTask(
 		entt::registry& registry,
 		entt::entity& entity,
 		world::Drone& drone,
-		world::DroneTask* task,
 		world::Inventory& inventory,
-		rendering::components::EulerComponentwiseTransform& transform,
-		double deltaTime
+		DroneCommand& command,
+		double time
 	) {
-		glm::vec2 destination = task->destination->getRelaxedPosition();
-		glm::vec2 currentPosition = glm::vec2(transform.getTranslation().x, transform.getTranslation().z);
-		if (currentPosition == destination)
+		if (drone.tasks.empty())
 		{
-			// Drone has reached its destination. Perform the intended action.
-			if (task->destinationReached(registry, entity, drone, inventory))
+			// Scoring the possible destinations for the drone's items can be done in parallel. Everything else depends on
+			// the shared queues of starving consumers, filled producers and buildings to place, so it is left to the
+			// commit phase.
+			for (size_t itemTypeIndex = 0; itemTypeIndex < world::AMOUNT_OF_ITEM_TYPES; itemTypeIndex++)
 			{
-				// Action was performed successfully. We can now delete it from the drone's tasks.
-				drone.tasks.pop();
-				delete task;
+				if (inventory.amounts[itemTypeIndex] == 0.0f)
+					continue;
+
+				world::IItem* item = world::getItemType(itemTypeIndex);
+				world::CellContent* destinationCellContent = findDeliveryCellContent(registry, entity, drone, item);
+				if (destinationCellContent != nullptr)
+				{
+					command.type = DroneCommandType::EMPTY_INVENTORY;
+					command.cellContent = destinationCellContent;
+					command.item = item;
+					command.plannedAmount = getPlannedAmount(registry, destinationCellContent->getEntity(), item, true);
+					return;
+				}
 			}
+
+			command.type = DroneCommandType::FIND_TASK;
+			return;
+		}
+
+		world::DroneTask& task = drone.tasks.front();
+		world::CellContent* replacementDestination = nullptr;
+		if (!checkTaskDestination(registry, entity, drone, inventory, task, replacementDestination))
+		{
+			// The current task is no longer valid and can therefore be no longer pursued.
+			command.type = DroneCommandType::DROP_TASK;
+			return;
+		}
+		else if (replacementDestination != nullptr)
+		{
+			bool delivery = task.type == world::DroneTaskType::DELIVERY;
+			command.type = DroneCommandType::REPLACE_DESTINATION;
+			command.cellContent = replacementDestination;
+			command.item = task.itemType;
+			command.plannedAmount = getPlannedAmount(registry, replacementDestination->getEntity(), task.itemType, delivery);
+			return;
+		}
+
+		glm::vec2 position = drone.leg.getPosition(time);
+		glm::vec2 destination = task.destination->getRelaxedPosition();
+		if (position == destination)
+		{
+			// Drone has reached its destination. The intended action is performed in the commit phase.
+			command.type = DroneCommandType::DESTINATION_REACHED;
 		}
 		else
 		{
-			// Drone has not yet reached its destination. Move towards the destination position.
-			glm::vec2 deltaToDestination = destination - currentPosition;
-			glm::vec2 direction = glm::normalize(deltaToDestination);
-			float distanceToDestination = glm::length(deltaToDestination);
+			// Drone has not yet reached its destination. Start a new leg towards the destination.
+			float speedMultiplier = getResourceProcessingContext(registry).droneMovementSpeedMultiplier;
+			drone.depart(world::DroneLeg{ position, destination, time, world::DRONE_MOVEMENT_SPEED * speedMultiplier });
+			command.type = DroneCommandType::DEPART;
+		}
+	}
+
+	void prepareDroneUpdate(entt::registry& registry, entt::entity entity, DroneCommand& command, double time, float brightness)
+	{
+		world::Drone& drone = registry.get<world::Drone>(entity);
+		auto& inventory = registry.get<world::Inventory>(entity);
 
-			float movementLength = world::DRONE_MOVEMENT_SPEED * droneMovementSpeedMultiplier * (float)deltaTime;
-			if (movementLength > distanceToDestination)
-				movementLength = distanceToDestination;
+		prepareDroneTask(registry, entity, drone, inventory, command, time);
 
-			glm::vec2 deltaPos = direction * movementLength;
-			glm::vec3 translation = transform.getTranslation();
-			glm::vec2 newPos = glm::vec2(translation.x, translation.z) + deltaPos;
-			transform.setTranslation(glm::vec3(newPos.x, 0.0f, newPos.y));
-			transform.setYaw(atan2(direction.x, direction.y));
+		// The drone's light is turned on if it pursues a task.
+		bool on = !drone.tasks.empty();
+		command.spotLightIntensity = on ? brightness : 0.0f;
+	}
+
+	void updateSpotLightIntensity(entt::registry& registry, world::Drone& drone, float spotLightIntensity)
+	{
+		// Patching the spot light notifies observers of the registry, so it is only done when the intensity changed.
+		if (drone.spotLightIntensity != spotLightIntensity)
+		{
+			drone.spotLightIntensity = spotLightIntensity;
+			registry.patch<rendering::components::SpotLight>(drone.spotLightEntity, [spotLightIntensity](auto& spotLight) {
+				spotLight.intensity = glm::vec3(50, 50, 50) * spotLightIntensity;
+			});
 		}
 	}
 
-	void tryPursueTask(
+	// The destinations found during the parallel phase were scored against the planned inventory changes from before the
+	// commit phase. If drones committed earlier during this update planned changes to the same destination, it may no
+	// longer be the best (or even a valid) destination, so the destination is searched again with the current plans.
+	world::CellContent* recheckDestination(
 		entt::registry& registry,
 		entt::entity& entity,
 		world::Drone& drone,
-		world::Inventory& inventory,
-		rendering::components::EulerComponentwiseTransform& transform,
-		double deltaTime
+		const DroneCommand& command,
+		bool delivery,
+		bool checkHarvestables
 	) {
-		world::DroneTask* task = drone.tasks.front();
-		if (task->checkAndUpdateDestination(registry, entity, drone, inventory))
+		entt::entity destinationEntity = command.cellContent->getEntity();
+		if (registry.valid(destinationEntity)
+			&& getPlannedAmount(registry, destinationEntity, command.item, delivery) == command.plannedAmount)
+			return command.cellContent;
+
+		if (delivery)
+			return findDeliveryCellContent(registry, entity, drone, command.item);
+		else
+			return findPickupCellContent(registry, entity, drone, command.item, checkHarvestables);
+	}
+
+	void commitDroneUpdate(entt::registry& registry, entt::entity entity, DroneCommand& command)
+	{
+		world::Drone& drone = registry.get<world::Drone>(entity);
+		auto& inventory = registry.get<world::Inventory>(entity);
+
+		switch (command.type)
 		{
-			// Task's destination is valid. Pursue the task by moving to the task's destination and performing the
-			// task's action.
-			pursueTask(registry, entity, drone, task, inventory, transform, deltaTime);
+		case DroneCommandType::FIND_TASK:
+			tryFindTask(registry, entity, drone, inventory);
+			break;
+		case DroneCommandType::EMPTY_INVENTORY:
+		{
+			world::CellContent* destinationCellContent = recheckDestination(registry, entity, drone, command, true, false);
+			if (destinationCellContent == nullptr)
+			{
+				tryFindTask(registry, entity, drone, inventory);
+				break;
+			}
+
+			world::Cell* destination = findNearestCell(registry, entity, destinationCellContent);
+			pushTask(drone.tasks, createDeliveryTask(registry, destination, command.item, inventory.getStoredAmount(command.item)));
+			break;
 		}
-		else
+		case DroneCommandType::REPLACE_DESTINATION:
 		{
-			// The current task is no longer valid and can therefore be no longer pursued. Delete it from the
-			// drone's tasks and continue with the next task on the next update.
+			world::DroneTask& task = drone.tasks.front();
+			bool delivery = task.type == world::DroneTaskType::DELIVERY;
+			world::CellContent* destinationCellContent = recheckDestination(registry, entity, drone, command, delivery, task.checkHarvestables);
+			if (destinationCellContent == nullptr)
+			{
+				// No replacement is left, so the task can no longer be pursued.
+				cancelPlannedInventoryChange(registry, task);
+				drone.tasks.pop();
+				break;
+			}
+
+			replaceTaskDestination(registry, entity, task, destinationCellContent);
+			break;
+		}
+		case DroneCommandType::DROP_TASK:
+			// Remove the invalid task from the drone's tasks and continue with the next task on the next update.
+			cancelPlannedInventoryChange(registry, drone.tasks.front());
 			drone.tasks.pop();
-			delete task;
+			break;
+		case DroneCommandType::DEPART:
+			registry.emplace<DroneInFlight>(entity);
+			getResourceProcessingContext(registry).droneArrivals.push(DroneArrival{ drone.leg.getArrivalTime(), entity });
+			break;
+		case DroneCommandType::DESTINATION_REACHED:
+			if (drone.tasks.front().type == world::DroneTaskType::CONSTRUCTION
+				&& !hasResourcesToBuild(inventory, drone.tasks.front().buildingType))
+			{
+				continueConstructionOrder(registry, entity, drone, drone.tasks.front());
+				drone.tasks.pop();
+			}
+			else if (taskDestinationReached(registry, entity, drone, inventory, drone.tasks.front()))
+			{
+				// Action was performed successfully. We can now remove it from the drone's tasks.
+				drone.tasks.pop();
+			}
+			break;
+		default:
+			break;
 		}
+
+		updateSpotLightIntensity(registry, drone, command.spotLightIntensity);
+	}
+
+	float getDroneSpotLightBrightness(entt::registry& registry)
+	{
+		auto& daynight = registry.ctx<DayNightCycle>();
+		return .25f + .75f * (1.f - daynight.getBrightness());
+	}
+
+	void updateDrones(entt::registry& registry)
+	{
+		auto& droneArrivals = getResourceProcessingContext(registry).droneArrivals;
+		double time = getSimulationTime(registry);
+		float brightness = getDroneSpotLightBrightness(registry);
+
+		// Wake up all drones which arrived at their destination.
+		while (!droneArrivals.empty() && droneArrivals.top().time <= time)
+		{
+			entt::entity entity = droneArrivals.top().entity;
+			droneArrivals.pop();
+
+			if (registry.valid(entity))
+				registry.remove_if_exists<DroneInFlight>(entity);
+		}
+
+		auto view = registry.view<world::Drone>(entt::exclude<DroneInFlight>);
+		std::vector<entt::entity> drones(view.begin(), view.end());
+		std::vector<DroneCommand> commands(drones.size());
+
+		// Views must not be created concurrently, as creating a view creates the component pool if it doesn't exist yet.
+		// Ensure that the pools of all item interactions which may be searched by the drones exist.
+		world::forEachItemType([&registry](auto* itemTypeTag) {
+			using ItemType = std::remove_pointer_t<decltype(itemTypeTag)>;
+
+			registry.view<world::Harvestable<ItemType>>();
+			registry.view<world::Stores<ItemType>>();
+			registry.view<world::Produces<ItemType>>();
+			registry.view<world::Consumes<ItemType>>();
+		});
+
+		std::for_each(std::execution::par, std::begin(drones), std::end(drones), [&](entt::entity& entity) {
+			size_t index = &entity - &drones[0];
+			prepareDroneUpdate(registry, entity, commands[index], time, brightness);
+		});
+
+		for (size_t i = 0; i < drones.size(); i++)
+			commitDroneUpdate(registry, drones[i], commands[i]);
+	}
+
+	// Calculates how far the drone is pushed aside by the drones around it, so that drones flying at the same height
+	// don't pass through each other. The push of each neighbour falls off smoothly with its distance, so that the offset
+	// changes continuously while the drones move past each other.
+	glm::vec2 calculateSeparationOffset(const DroneAnimations& animations, uint32_t index)
+	{
+		const DroneAnimation& animation = animations.drones[index];
+		glm::vec2 offset(0.0f);
+
+		animations.spatialHash.forEachItemNear(animation.position, [&](uint32_t neighbourIndex) {
+			const DroneAnimation& neighbour = animations.drones[neighbourIndex];
+			if (neighbourIndex == index || std::abs(neighbour.height - animation.height) >= world::DRONE_FLIGHT_LANE_SPACING)
+				return;
+
+			glm::vec2 away = animation.position - neighbour.position;
+			float squaredDistance = glm::dot(away, away);
+			if (squaredDistance >= world::DRONE_SEPARATION_RADIUS * world::DRONE_SEPARATION_RADIUS)
+				return;
+
+			// Drones at the exact same position are pushed apart along an arbitrary, but consistent axis.
+			float distance = sqrt(squaredDistance);
+			glm::vec2 direction = distance > 0.001f ? away / distance : glm::vec2(index < neighbourIndex ? 1.0f : -1.0f, 0.0f);
+			float weight = 1.0f - distance / world::DRONE_SEPARATION_RADIUS;
+			offset += direction * weight * weight;
+		});
+
+		float length = glm::length(offset);
+		if (length > 1.0f)
+			offset /= length;
+		return offset * world::DRONE_SEPARATION_STRENGTH;
 	}
 
-	void updateDrone(
+	void updateDroneAnimations(
 		entt::registry& registry,
-		entt::entity& entity,
-		world::Drone& drone,
-		double deltaTime,
+		const std::array<glm::vec4, 6>& cameraFrustum,
 		world::HeightGenerator& heightGenerator
 	) {
-		auto& transform = registry.get<rendering::components::EulerComponentwiseTransform>(entity);
-		auto& inventory = registry.get<world::Inventory>(entity);
+		double time = getSimulationTime(registry);
+		float brightness = getDroneSpotLightBrightness(registry);
+		float rotation = fmodf(time * world::DRONE_ROTOR_ROTATION_SPEED, 2.0f * M_PI);
 
-		if (drone.tasks.empty())
-			tryFindTask(registry, entity, drone, inventory);
-		else
-			tryPursueTask(registry, entity, drone, inventory, transform, deltaTime);
+		auto view = registry.view<world::Drone, rendering::components::EulerComponentwiseTransform, rendering::components::CullingGeometry>();
+		DroneAnimations& animations = getResourceProcessingContext(registry).droneAnimations;
+		animations.drones.clear();
+		for (auto entity : view)
+			animations.drones.push_back(DroneAnimation{ entity });
+		animations.buckets.resize(animations.drones.size());
+		animations.spatialHash.resize(animations.drones.size());
+
+		// Evaluate the positions of all drones and determine which of them are visible. This also computes the bucket of
+		// each drone in the spatial hash, so that sorting the drones into the hash afterwards is a single linear pass.
+		std::for_each(std::execution::par, animations.drones.begin(), animations.drones.end(), [&](DroneAnimation& animation) {
+			auto& drone = view.get<world::Drone>(animation.entity);
+			auto& transform = view.get<rendering::components::EulerComponentwiseTransform>(animation.entity);
+			auto& cullingGeometry = view.get<rendering::components::CullingGeometry>(animation.entity);
+
+			// The height of the drone's last animation update is close enough for culling, so that the terrain height only
+			// needs to be sampled for visible drones.
+			animation.position = drone.leg.getPosition(time);
+			animation.height = drone.getHeightAboveGround(time);
+			glm::vec3 cullingPosition = glm::vec3(animation.position.x, transform.getTranslation().y, animation.position.y);
+			bool visible = cullingGeometry.boundingGeometry->isInCameraFrustum(cameraFrustum, glm::translate(cullingPosition));
+
+			// Drones which just left the camera frustum are updated one last time, so that they aren't rendered at the edge
+			// of the screen.
+			animation.animate = visible || drone.visible;
+			drone.visible = visible;
+
+			animations.buckets[&animation - &animations.drones[0]] = animations.spatialHash.getBucket(animation.position);
+		});
 
-		// Let the drone wobble slightly up and down to make its flight look more realistic.
-		double time = glfwGetTime();
-		glm::vec3 translation = transform.getTranslation();
-		float height = heightGenerator.getHeight(translation.x, translation.z)
-			+ drone.heightAboveGround
-			+ world::DRONE_WOBBLE_HEIGHT * sin(time * world::DRONE_WOBBLE_SPEED * drone.relativeWobbleSpeed);
-		transform.setTranslation(glm::vec3(translation.x, height, translation.z));
+		animations.spatialHash.build(animations.buckets);
 
-		// Update the drone's light if it pursues a task
-		bool on = !drone.tasks.empty();
-		auto& daynight = registry.ctx<DayNightCycle>();
-		float brightness = .25f + .75f * (1.f - daynight.getBrightness());
-		registry.patch<rendering::components::SpotLight>(drone.spotLightEntity, [on, brightness](auto& spotLight) {
-			spotLight.intensity = glm::vec3(50, 50, 50) * (on ? brightness : 0.f);
+		// Each drone only writes its own transforms, so the drones can be animated in parallel. Patching the spot lights
+		// notifies the observers of the registry, which is left to the sequential loop below.
+		std::for_each(std::execution::par, animations.drones.begin(), animations.drones.end(), [&](DroneAnimation& animation) {
+			if (!animation.animate)
+				return;
+
+			auto& drone = view.get<world::Drone>(animation.entity);
+			auto& transform = view.get<rendering::components::EulerComponentwiseTransform>(animation.entity);
+
+			uint32_t animationIndex = (uint32_t) (&animation - &animations.drones[0]);
+			glm::vec2 position = animation.position + calculateSeparationOffset(animations, animationIndex);
+
+			// Let the drone wobble slightly up and down to make its flight look more realistic.
+			float height = heightGenerator.getHeight(position.x, position.y)
+				+ animation.height
+				+ world::DRONE_WOBBLE_HEIGHT * sin(time * world::DRONE_WOBBLE_SPEED * drone.relativeWobbleSpeed);
+			transform.setTranslation(glm::vec3(position.x, height, position.y));
+			if (drone.leg.start != drone.leg.end)
+				transform.setYaw(drone.leg.getYaw());
+
+			// Update the rotation of the drone's rotors.
+			registry.get<rendering::components::EulerComponentwiseTransform>(drone.rotor1Entity).setYaw(rotation);
+			registry.get<rendering::components::EulerComponentwiseTransform>(drone.rotor2Entity).setYaw(rotation);
+			registry.get<rendering::components::EulerComponentwiseTransform>(drone.rotor3Entity).setYaw(rotation);
 		});
 
-		// Update the rotation of the drone's rotors.
-		float rotation = fmodf(time * world::DRONE_ROTOR_ROTATION_SPEED, 2.0f * M_PI);
-		registry.get<rendering::components::EulerComponentwiseTransform>(drone.rotor1Entity).setYaw(rotation);
-		registry.get<rendering::components::EulerComponentwiseTransform>(drone.rotor2Entity).setYaw(rotation);
-		registry.get<rendering::components::EulerComponentwiseTransform>(drone.rotor3Entity).setYaw(rotation);
+		for (DroneAnimation& animation : animations.drones)
+		{
+			auto& drone = view.get<world::Drone>(animation.entity);
+			if (animation.animate && drone.spotLightIntensity != 0.0f)
+				updateSpotLightIntensity(registry, drone, brightness);
+		}
 	}
 
-	void updateResourceProcessingSystem(entt::registry& registry, double deltaTime, world::HeightGenerator& heightGenerator)
+	void updateResourceProcessingSystem(entt::registry& registry, double deltaTime)
 	{
-		for (IResourceProcessor* resourceProcessor : resourceProcessors)
-			resourceProcessor->processResources(registry, deltaTime);
+		auto& context = getResourceProcessingContext(registry);
 
-		filledProducers = std::priority_queue<EntityAmount, std::vector<EntityAmount>, MaxPriorityQueue>();
-		starvingConsumers = std::priority_queue<EntityAmount, std::vector<EntityAmount>, MinPriorityQueue>();
-
-		for (std::shared_ptr<world::IItem> itemType : itemTypes)
+		// Process all buildings whose next production or consumption is due. Processing a building may schedule it again.
+		double time = getSimulationTime(registry);
+		auto& scheduledResourceProcessings = context.scheduledResourceProcessings;
+		while (!scheduledResourceProcessings.empty() && scheduledResourceProcessings.top().time <= time)
 		{
-			itemType->getConsumes()->iterateAllEntities(registry, std::function([&registry, itemType](entt::entity& entity, world::IConsumes* consumes) {
-				float plannedAmount = registry.get<world::Inventory>(entity).getStoredAmount(itemType);
-				auto& found = plannedInventoryChanges.find(entity);
-				if (found != plannedInventoryChanges.end())
-					plannedAmount += found->second.plannedDeliveries.getStoredAmount(itemType);
-				
-				if (plannedAmount <= world::RESOURCE_MANAGEMENT_RESUPPLY_CONSUMER_UNDER)
-					starvingConsumers.push(EntityAmount{ entity, itemType, plannedAmount });
-			}));
-
-			itemType->getProduces()->iterateAllEntities(registry, std::function([&registry, itemType](entt::entity& entity, world::IProduces* produces) {
-				float plannedAmount = registry.get<world::Inventory>(entity).getStoredAmount(itemType);
-				auto& found = plannedInventoryChanges.find(entity);
-				if (found != plannedInventoryChanges.end())
-					plannedAmount -= found->second.plannedPickups.getStoredAmount(itemType);
+			ScheduledResourceProcessing scheduled = scheduledResourceProcessings.top();
+			scheduledResourceProcessings.pop();
 
-				if (plannedAmount >= world::RESOURCE_MANAGEMENT_EMPTY_PRODUCER_ABOVE)
-					filledProducers.push(EntityAmount{ entity, itemType, plannedAmount });
-			}));
+			if (registry.valid(scheduled.entity))
+			{
+				scheduled.resourceProcessor->processResources(registry, scheduled.entity, scheduled.time);
+				markInventoryChanged(registry, scheduled.entity);
+			}
+			else
+			{
+				context.resourceProcessors.erase(scheduled.entity);
+			}
 		}
 
-		registry.view<world::Drone>().each([&registry, deltaTime, &heightGenerator](auto entity, auto& drone) {
-			updateDrone(registry, entity, drone, deltaTime, heightGenerator);
-		});
+		updateFilledProducersAndStarvingConsumers(registry);
+
+		wakeConstructionOrdersWaitingForItems(registry);
+		updateDrones(registry);
 	}
 
-	void enqueueConstruction(world::Cell* cell, world::IBuilding* buildingType)
+	void enqueueConstruction(entt::registry& registry, world::Cell* cell, world::IBuilding* buildingType)
 	{
 		if (!buildingType->canBePlacedOnCell(cell))
 			return;
 
-		buildingsToPlace.push(std::make_pair(cell, buildingType));
+		addToConstructionBacklog(getResourceProcessingContext(registry), ConstructionOrder{ cell, buildingType });
 		buildingType->displayPlannedBuildingOfThisTypeOnCell(cell);
 	}
 
-	void enqueueDestruction(world::Cell* cell)
+	void enqueueDestruction(entt::registry& registry, world::Cell* cell)
 	{
-		buildingsToRemove.push(cell);
+		getResourceProcessingContext(registry).buildingsToRemove.push(cell);
 		cell->displayPlannedRemoval();
 	}
 
-	void attachResourceProcessor(IResourceProcessor* resourceProcessor)
+	float getDroneMovementSpeedMultiplier(entt::registry& registry)
+	{
+		return getResourceProcessingContext(registry).droneMovementSpeedMultiplier;
+	}
+
+	void setDroneMovementSpeedMultiplier(entt::registry& registry, float multiplier)
+	{
+		getResourceProcessingContext(registry).droneMovementSpeedMultiplier = multiplier;
+	}
+
+	void scheduleResourceProcessing(
+		entt::registry& registry,
+		IResourceProcessor* resourceProcessor,
+		entt::entity entity,
+		double time
+	) {
+		auto& context = getResourceProcessingContext(registry);
+		context.scheduledResourceProcessings.push(ScheduledResourceProcessing{ time, entity, resourceProcessor });
+		context.resourceProcessors[entity] = resourceProcessor;
+		markInventoryChanged(registry, entity);
+	}
+
+	void updateSimulationFocus(entt::registry& registry, glm::vec2 focus)
 	{
-		resourceProcessors.insert(resourceProcessor);
+		auto& context = getResourceProcessingContext(registry);
+		context.simulationFocus = focus;
+
+		bool refocus = !context.hasSimulationFocus || glm::distance(focus, context.lastRefocus) > world::SIMULATION_LOD_REFOCUS_DISTANCE;
+		context.hasSimulationFocus = true;
+		if (!refocus)
+			return;
+
+		// Buildings which are now near the focus must not wait for the end of their coarse step. Catching up also schedules
+		// them again with the amount of steps according to their new distance.
+		context.lastRefocus = focus;
+		for (auto& entityAndProcessor : context.resourceProcessors)
+			if (registry.valid(entityAndProcessor.first) && getSimulationSteps(registry, entityAndProcessor.first) == 1)
+				entityAndProcessor.second->catchUp(registry, entityAndProcessor.first, getSimulationTime(registry));
 	}
 
-	void registerItemType(std::shared_ptr<world::IItem> item)
+	unsigned int getSimulationSteps(entt::registry& registry, entt::entity entity)
 	{
-		itemTypes.insert(item);
+		auto& context = getResourceProcessingContext(registry);
+		if (!context.hasSimulationFocus)
+			return 1;
+
+		auto* cellContent = registry.try_get<world::CellContentComponent>(entity);
+		if (cellContent == nullptr || cellContent->cellContent->getCells().empty())
+			return 1;
+
+		world::Cell* cell = cellContent->cellContent->getCells().begin()->first;
+		float squaredDistance = glm::distance2(cell->getRelaxedPosition(), context.simulationFocus);
+		if (squaredDistance > world::SIMULATION_LOD_DISTANCE * world::SIMULATION_LOD_DISTANCE)
+			return world::SIMULATION_LOD_COARSE_STEPS;
+		else
+			return 1;
 	}
+
+	void catchUpResourceProcessing(entt::registry& registry, entt::entity entity)
+	{
+		auto& resourceProcessors = getResourceProcessingContext(registry).resourceProcessors;
+		auto found = resourceProcessors.find(entity);
+		if (found != resourceProcessors.end())
+			found->second->catchUp(registry, entity, getSimulationTime(registry));
+	}
+
+
 }
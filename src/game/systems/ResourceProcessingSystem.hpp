@@ -1,39 +1,91 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <execution>
 #include <limits>
 #include <math.h>
 #include <queue>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <entt/entt.hpp>
 
 #include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
 
 #include "../DayNightCycle.hpp"
+#include "../SimulationTime.hpp"
 #include "../world/BuildingPieceSet.hpp"
 #include "../world/Chunk.hpp"
 #include "../world/Constants.hpp"
 #include "../world/Drone.hpp"
 #include "../world/HeightGenerator.hpp"
 #include "../world/Inventory.hpp"
+#include "../world/Item.hpp"
+#include "../../util/SpatialHash.hpp"
+#include "WarehouseIndex.hpp"
 
 namespace game::systems
 {
+	// Processes the resources of buildings. Instead of iterating over all of its buildings each frame, a resource processor
+	// schedules each building for the simulation time at which its next production or consumption is due, so that buildings
+	// which are idle or waiting don't cost anything.
+	// Resource processors must not have any state of their own (everything is stored in components of the registry), as
+	// they are shared by all worlds.
 	struct IResourceProcessor
 	{
-		virtual void processResources(entt::registry& registry, double deltaTime) = 0;
+		virtual void processResources(entt::registry& registry, entt::entity entity, double scheduledTime) = 0;
+
+		// Processes all productions or consumptions of the given entity which are due at the given time, but which were
+		// deferred as the entity is simulated in coarse steps. Afterwards, the entity must be scheduled again. Resource
+		// processors which don't support coarse steps don't need to override this.
+		virtual void catchUp(entt::registry& registry, entt::entity entity, double time) {}
 	};
 
-	void updateResourceProcessingSystem(entt::registry& registry, double deltaTime, world::HeightGenerator& heightGenerator);
+	void updateResourceProcessingSystem(entt::registry& registry, double deltaTime);
+
+	// Updates the transforms, rotors and lights of all drones which are inside the given camera frustum. Drones outside of
+	// the camera frustum are neither moved nor animated. Visible drones are pushed apart from nearby drones flying at the
+	// same height, which are found using a spatial hash that is rebuilt each frame.
+	void updateDroneAnimations(
+		entt::registry& registry,
+		const std::array<glm::vec4, 6>& cameraFrustum,
+		world::HeightGenerator& heightGenerator
+	);
+
+	void enqueueConstruction(entt::registry& registry, world::Cell* cell, world::IBuilding* buildingType);
+
+	void enqueueDestruction(entt::registry& registry, world::Cell* cell);
+
+	float getDroneMovementSpeedMultiplier(entt::registry& registry);
+
+	void setDroneMovementSpeedMultiplier(entt::registry& registry, float multiplier);
 
-	void enqueueConstruction(world::Cell* cell, world::IBuilding* buildingType);
+	// Schedules the given entity to be processed by the resource processor once the simulation time reaches the given time.
+	// An entity may be scheduled multiple times, so resource processors must ignore outdated schedules.
+	void scheduleResourceProcessing(
+		entt::registry& registry,
+		IResourceProcessor* resourceProcessor,
+		entt::entity entity,
+		double time
+	);
 
-	void enqueueDestruction(world::Cell* cell);
+	// Sets the position around which buildings are simulated at full rate (usually the camera's position). Buildings which
+	// come close to the focus catch up on their deferred production steps. Without a focus, everything is simulated at
+	// full rate.
+	void updateSimulationFocus(entt::registry& registry, glm::vec2 focus);
 
-	void attachResourceProcessor(IResourceProcessor* resourceProcessor);
+	// Returns the amount of production steps which the given entity should process at once. This is 1 near the simulation
+	// focus and SIMULATION_LOD_COARSE_STEPS far away from it. Processing n steps at once must yield the same result as
+	// processing n single steps, so that the totals don't depend on the position of the camera.
+	unsigned int getSimulationSteps(entt::registry& registry, entt::entity entity);
 
-	void registerItemType(std::shared_ptr<world::IItem> item);
+	// Processes the production steps of the given entity which are due by now, but which were deferred by a coarse step.
+	// Must be called before the entity's inventory is accessed on demand.
+	void catchUpResourceProcessing(entt::registry& registry, entt::entity entity);
 }
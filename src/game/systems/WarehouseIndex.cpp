@@ -0,0 +1,158 @@
+#include "WarehouseIndex.hpp"
+
+namespace game::systems
+{
+	WarehouseIndex& getWarehouseIndex(entt::registry& registry)
+	{
+		return registry.ctx_or_set<WarehouseIndex>();
+	}
+
+	const WarehouseIndex* findWarehouseIndex(const entt::registry& registry)
+	{
+		return registry.try_ctx<WarehouseIndex>();
+	}
+
+	glm::ivec2 getWarehouseRegion(glm::vec2 position)
+	{
+		return glm::ivec2(glm::floor(position / world::WAREHOUSE_REGION_SIZE));
+	}
+
+	int64_t getRegionKey(glm::ivec2 region)
+	{
+		return (int64_t(region.x) << 32) | uint32_t(region.y);
+	}
+
+	const WarehouseRegion* findWarehouseRegion(const WarehouseIndex& index, glm::ivec2 region)
+	{
+		auto found = index.warehouseRegions.find(getRegionKey(region));
+		return found != index.warehouseRegions.end() ? &found->second : nullptr;
+	}
+
+	void addStorageToRegion(WarehouseIndex& index, entt::entity storage, IndexedStorage& indexed, glm::ivec2 region)
+	{
+		if (index.warehouseRegions.empty())
+		{
+			index.minRegion = region;
+			index.maxRegion = region;
+		}
+		else
+		{
+			index.minRegion = glm::min(index.minRegion, region);
+			index.maxRegion = glm::max(index.maxRegion, region);
+		}
+
+		WarehouseRegion& warehouseRegion = index.warehouseRegions[getRegionKey(region)];
+		warehouseRegion.storages.push_back(storage);
+		for (size_t i = 0; i < world::AMOUNT_OF_ITEM_TYPES; i++)
+			warehouseRegion.storedAmounts[i] += indexed.indexedAmounts.amounts[i];
+		indexed.regions.push_back(region);
+	}
+
+	void removeStorageFromRegion(WarehouseIndex& index, entt::entity storage, const IndexedStorage& indexed, glm::ivec2 region)
+	{
+		auto foundRegion = index.warehouseRegions.find(getRegionKey(region));
+		WarehouseRegion& warehouseRegion = foundRegion->second;
+		warehouseRegion.storages.erase(std::find(warehouseRegion.storages.begin(), warehouseRegion.storages.end(), storage));
+		if (warehouseRegion.storages.empty())
+		{
+			index.warehouseRegions.erase(foundRegion);
+			return;
+		}
+
+		for (size_t i = 0; i < world::AMOUNT_OF_ITEM_TYPES; i++)
+			warehouseRegion.storedAmounts[i] -= indexed.indexedAmounts.amounts[i];
+	}
+
+	void setStorageCellsInWarehouseIndex(entt::registry& registry, entt::entity storage, const std::vector<glm::vec2>& cellPositions)
+	{
+		if (cellPositions.empty())
+		{
+			removeStorageFromWarehouseIndex(registry, storage);
+			return;
+		}
+
+		std::vector<glm::ivec2> regions;
+		for (glm::vec2 position : cellPositions)
+		{
+			glm::ivec2 region = getWarehouseRegion(position);
+			if (std::find(regions.begin(), regions.end(), region) == regions.end())
+				regions.push_back(region);
+		}
+
+		WarehouseIndex& index = getWarehouseIndex(registry);
+		auto found = index.indexedStorages.find(storage);
+		bool added = found == index.indexedStorages.end();
+		if (added)
+			found = index.indexedStorages.insert(std::make_pair(storage, IndexedStorage{})).first;
+
+		IndexedStorage& indexed = found->second;
+		for (size_t i = 0; i < indexed.regions.size();)
+		{
+			if (std::find(regions.begin(), regions.end(), indexed.regions[i]) != regions.end())
+			{
+				i++;
+				continue;
+			}
+
+			removeStorageFromRegion(index, storage, indexed, indexed.regions[i]);
+			indexed.regions[i] = indexed.regions.back();
+			indexed.regions.pop_back();
+		}
+
+		for (glm::ivec2 region : regions)
+			if (std::find(indexed.regions.begin(), indexed.regions.end(), region) == indexed.regions.end())
+				addStorageToRegion(index, storage, indexed, region);
+
+		if (added)
+			updateStorageInWarehouseIndex(registry, storage);
+	}
+
+	void removeStorageFromWarehouseIndex(entt::registry& registry, entt::entity storage)
+	{
+		WarehouseIndex* existingIndex = registry.try_ctx<WarehouseIndex>();
+		if (existingIndex == nullptr)
+			return;
+
+		WarehouseIndex& index = *existingIndex;
+		auto found = index.indexedStorages.find(storage);
+		if (found == index.indexedStorages.end())
+			return;
+
+		IndexedStorage indexed = found->second;
+		index.indexedStorages.erase(found);
+
+		for (glm::ivec2 region : indexed.regions)
+			removeStorageFromRegion(index, storage, indexed, region);
+		for (size_t i = 0; i < world::AMOUNT_OF_ITEM_TYPES; i++)
+			index.totalStoredAmounts[i] -= indexed.indexedAmounts.amounts[i];
+	}
+
+	void updateStorageInWarehouseIndex(entt::registry& registry, entt::entity storage)
+	{
+		WarehouseIndex& index = getWarehouseIndex(registry);
+		auto found = index.indexedStorages.find(storage);
+		if (found == index.indexedStorages.end())
+			return;
+
+		IndexedStorage& indexed = found->second;
+		const world::Inventory& inventory = registry.get<world::Inventory>(storage);
+
+		for (size_t i = 0; i < world::AMOUNT_OF_ITEM_TYPES; i++)
+		{
+			float delta = inventory.amounts[i] - indexed.indexedAmounts.amounts[i];
+			if (delta == 0.0f)
+				continue;
+
+			indexed.indexedAmounts.amounts[i] = inventory.amounts[i];
+			index.totalStoredAmounts[i] += delta;
+			for (glm::ivec2 region : indexed.regions)
+				index.warehouseRegions.at(getRegionKey(region)).storedAmounts[i] += delta;
+		}
+	}
+
+	float getTotalStoredAmount(const entt::registry& registry, const world::IItem* itemType)
+	{
+		const WarehouseIndex* index = findWarehouseIndex(registry);
+		return index != nullptr ? index->totalStoredAmounts[itemType->index] : 0.0f;
+	}
+}
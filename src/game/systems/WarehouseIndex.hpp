@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include "../world/Constants.hpp"
+#include "../world/Inventory.hpp"
+
+namespace game::systems
+{
+	// The warehouse index aggregates the inventories of all storage buildings. Storages are grouped into square regions of
+	// WAREHOUSE_REGION_SIZE, and the stored amount of each item type is tracked in total and per region. This allows to
+	// answer questions like "which is the nearest storage storing wood" without iterating over all storages. A storage
+	// spanning several regions belongs to each region containing one of its cells (and its amounts are accounted for in
+	// each of these regions), so that the region of its nearest cell is always visited.
+	struct WarehouseRegion
+	{
+		std::vector<entt::entity> storages;
+		std::array<float, world::AMOUNT_OF_ITEM_TYPES> storedAmounts{};
+	};
+
+	struct IndexedStorage
+	{
+		std::vector<glm::ivec2> regions;
+
+		// The amounts which are currently accounted for in the index.
+		world::Inventory indexedAmounts;
+	};
+
+	// The warehouse index is stored in the context of the registry, so that each world has its own index.
+	struct WarehouseIndex
+	{
+		std::unordered_map<int64_t, WarehouseRegion> warehouseRegions;
+		std::unordered_map<entt::entity, IndexedStorage> indexedStorages;
+		std::array<float, world::AMOUNT_OF_ITEM_TYPES> totalStoredAmounts{};
+
+		glm::ivec2 minRegion{ 0 };
+		glm::ivec2 maxRegion{ 0 };
+	};
+
+	// Adds the storage to the regions of the given cell positions and removes it from all other regions. The storage is
+	// removed from the index if there are no cell positions.
+	void setStorageCellsInWarehouseIndex(entt::registry& registry, entt::entity storage, const std::vector<glm::vec2>& cellPositions);
+
+	void removeStorageFromWarehouseIndex(entt::registry& registry, entt::entity storage);
+
+	// Must be called whenever the inventory of an indexed storage was changed.
+	void updateStorageInWarehouseIndex(entt::registry& registry, entt::entity storage);
+
+	float getTotalStoredAmount(const entt::registry& registry, const world::IItem* itemType);
+
+	// Queries don't create the index, so that they can be answered concurrently. Returns nullptr if no storage was added yet.
+	const WarehouseIndex* findWarehouseIndex(const entt::registry& registry);
+
+	glm::ivec2 getWarehouseRegion(glm::vec2 position);
+
+	// Returns nullptr if there is no storage in the given region.
+	const WarehouseRegion* findWarehouseRegion(const WarehouseIndex& index, glm::ivec2 region);
+
+	// Calls func(entt::entity storage) for the storages in rings of regions of increasing distance around the given
+	// position. Before visiting a region whose storages are at least minDistance away, canContainBetterStorage(storedAmounts,
+	// minDistance) is asked with the region's stored amounts whether any of its storages could be better than the best one
+	// found so far. Before each ring, it is asked with the total stored amounts, and the search ends as soon as no region of
+	// the ring can contain a better storage. Storages have no capacity limit, so every storage has space for further items.
+	// Storages spanning several regions may be visited more than once.
+	template <class Bound, class Func>
+	void forEachStorageNear(const entt::registry& registry, glm::vec2 position, Bound canContainBetterStorage, Func func)
+	{
+		const WarehouseIndex* index = findWarehouseIndex(registry);
+		if (index == nullptr || index->warehouseRegions.empty())
+			return;
+
+		glm::ivec2 center = getWarehouseRegion(position);
+		int maxRing = std::max({
+			std::abs(center.x - index->minRegion.x), std::abs(center.x - index->maxRegion.x),
+			std::abs(center.y - index->minRegion.y), std::abs(center.y - index->maxRegion.y)
+		});
+
+		auto visitRegion = [index, &canContainBetterStorage, &func](glm::ivec2 regionCoordinates, float minDistance) {
+			const WarehouseRegion* region = findWarehouseRegion(*index, regionCoordinates);
+			if (region == nullptr || !canContainBetterStorage(region->storedAmounts, minDistance))
+				return;
+
+			for (entt::entity storage : region->storages)
+				func(storage);
+		};
+
+		for (int ring = 0; ring <= maxRing; ring++)
+		{
+			// Any storage in this ring is at least (ring - 1) region sizes away from the position.
+			float minDistance = std::max(0, ring - 1) * world::WAREHOUSE_REGION_SIZE;
+			if (!canContainBetterStorage(index->totalStoredAmounts, minDistance))
+				break;
+
+			for (int x = center.x - ring; x <= center.x + ring; x++)
+			{
+				if (std::abs(x - center.x) == ring)
+				{
+					for (int y = center.y - ring; y <= center.y + ring; y++)
+						visitRegion(glm::ivec2(x, y), minDistance);
+				}
+				else
+				{
+					visitRegion(glm::ivec2(x, center.y - ring), minDistance);
+					visitRegion(glm::ivec2(x, center.y + ring), minDistance);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,149 @@
+#include "BuildingPieceSet.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace game::world
+{
+	// Whether the other piece may be placed next to the piece in the given direction. Pieces don't list any fitting pieces
+	// in the directions in which they don't have neighbors (e.g. the front of a straight edge), so an empty list doesn't
+	// restrict the neighbor at all.
+	static bool fits(BuildingPiece& piece, BuildingPieceDirection direction, BuildingPiece& other)
+	{
+		const std::vector<std::string>& fittingPieces = piece.getFits(direction);
+		return fittingPieces.empty()
+			|| std::find(fittingPieces.begin(), fittingPieces.end(), other.getId()) != fittingPieces.end();
+	}
+
+	static size_t countPieces(BuildingPieceDomain pieces)
+	{
+		size_t amount = 0;
+		for (; pieces != 0; pieces &= pieces - 1)
+			amount++;
+		return amount;
+	}
+
+	// Chooses one of the possible pieces. The choice only depends on the variant and the position within the column, so
+	// that the same column and variant always result in the same pieces.
+	static uint8_t choosePiece(BuildingPieceDomain pieces, size_t variant, size_t position)
+	{
+		uint32_t hash = ((uint32_t)variant * 73856093u ^ (uint32_t)position * 19349663u) * 2654435761u;
+		size_t choice = (hash >> 16) % countPieces(pieces);
+
+		uint8_t piece = 0;
+		for (;; piece++)
+		{
+			if ((pieces & ((BuildingPieceDomain)1 << piece)) == 0)
+				continue;
+			if (choice-- == 0)
+				return piece;
+		}
+	}
+
+	std::vector<uint8_t> BuildingPieceSet::solveColumn(const std::vector<BuildingPieceSlot>& slots, size_t variant) const
+	{
+		// All variants of a column result in the same pieces if there is only a single piece per slot.
+		if (!hasVariants)
+			variant = 0;
+
+		// Start with all pieces of each slot being possible and remove (from top to bottom) all pieces which don't fit any
+		// of the remaining pieces above them. As the column is a chain, each remaining piece has a fitting piece above it
+		// afterwards, so the pieces can be chosen from bottom to top without ever running into a contradiction.
+		std::vector<BuildingPieceDomain> domains(slots.size());
+		for (size_t i = 0; i < slots.size(); i++)
+			domains[i] = allPiecesPerSlot[(size_t)slots[i]];
+
+		bool contradiction = false;
+		for (size_t i = slots.size(); i-- > 1 && !contradiction;)
+		{
+			if (slots[i] == BuildingPieceSlot::NONE || slots[i - 1] == BuildingPieceSlot::NONE)
+				continue;
+
+			// Most slots still have all of their pieces left, so the pieces supported by them are looked up in the
+			// precomputed pairwise table.
+			BuildingPieceSlot upper = slots[i];
+			BuildingPieceSlot lower = slots[i - 1];
+			domains[i - 1] &= domains[i] == allPiecesPerSlot[(size_t)upper]
+				? piecesSupportedFromAbove[(size_t)lower][(size_t)upper]
+				: getPiecesFittingBelow(upper, domains[i], lower);
+			contradiction = domains[i - 1] == 0;
+		}
+
+		// If the adjacency rules can't be satisfied, the first piece of each slot is used.
+		std::vector<uint8_t> solution(slots.size(), 0);
+		for (size_t i = 0; i < slots.size() && !contradiction; i++)
+		{
+			if (slots[i] == BuildingPieceSlot::NONE)
+				continue;
+
+			BuildingPieceDomain pieces = domains[i];
+			if (i > 0 && slots[i - 1] != BuildingPieceSlot::NONE)
+				pieces &= piecesFittingAbove[(size_t)slots[i - 1]][solution[i - 1]][(size_t)slots[i]];
+			solution[i] = choosePiece(pieces, variant, i);
+		}
+
+		return solution;
+	}
+
+	void BuildingPieceSet::createPieceDomains()
+	{
+		for (size_t slot = 0; slot < AMOUNT_OF_BUILDING_PIECE_SLOTS; slot++)
+		{
+			size_t amountOfPieces = piecesPerSlot[slot].size();
+			if (amountOfPieces > MAX_BUILDING_PIECES_PER_SLOT)
+				throw std::invalid_argument("A building piece set can't have more than 64 pieces per slot!");
+
+			allPiecesPerSlot[slot] = amountOfPieces == MAX_BUILDING_PIECES_PER_SLOT
+				? ~(BuildingPieceDomain)0
+				: ((BuildingPieceDomain)1 << amountOfPieces) - 1;
+			hasVariants |= amountOfPieces > 1;
+		}
+
+		// The string based rules are only evaluated once. Two pieces may only be placed on top of each other if both of
+		// them accept the other one.
+		for (size_t slot = 0; slot < AMOUNT_OF_BUILDING_PIECE_SLOTS; slot++)
+		{
+			piecesFittingAbove[slot].resize(piecesPerSlot[slot].size());
+			piecesFittingBelow[slot].resize(piecesPerSlot[slot].size());
+			for (size_t piece = 0; piece < piecesPerSlot[slot].size(); piece++)
+			{
+				BuildingPiece& current = *piecesPerSlot[slot][piece];
+				for (size_t otherSlot = 0; otherSlot < AMOUNT_OF_BUILDING_PIECE_SLOTS; otherSlot++)
+				{
+					BuildingPieceDomain fittingAbove = 0;
+					BuildingPieceDomain fittingBelow = 0;
+					for (size_t otherPiece = 0; otherPiece < piecesPerSlot[otherSlot].size(); otherPiece++)
+					{
+						BuildingPiece& other = *piecesPerSlot[otherSlot][otherPiece];
+						if (fits(current, BuildingPieceDirection::UP, other) && fits(other, BuildingPieceDirection::DOWN, current))
+							fittingAbove |= (BuildingPieceDomain)1 << otherPiece;
+						if (fits(current, BuildingPieceDirection::DOWN, other) && fits(other, BuildingPieceDirection::UP, current))
+							fittingBelow |= (BuildingPieceDomain)1 << otherPiece;
+					}
+					piecesFittingAbove[slot][piece][otherSlot] = fittingAbove;
+					piecesFittingBelow[slot][piece][otherSlot] = fittingBelow;
+				}
+			}
+		}
+
+		for (size_t lowerSlot = 0; lowerSlot < AMOUNT_OF_BUILDING_PIECE_SLOTS; lowerSlot++)
+			for (size_t upperSlot = 0; upperSlot < AMOUNT_OF_BUILDING_PIECE_SLOTS; upperSlot++)
+				piecesSupportedFromAbove[lowerSlot][upperSlot] = getPiecesFittingBelow(
+					(BuildingPieceSlot)upperSlot,
+					allPiecesPerSlot[upperSlot],
+					(BuildingPieceSlot)lowerSlot
+				);
+	}
+
+	BuildingPieceDomain BuildingPieceSet::getPiecesFittingBelow(
+		BuildingPieceSlot upperSlot,
+		BuildingPieceDomain upperPieces,
+		BuildingPieceSlot lowerSlot
+	) const {
+		BuildingPieceDomain result = 0;
+		for (size_t piece = 0; upperPieces != 0; piece++, upperPieces >>= 1)
+			if (upperPieces & 1)
+				result |= piecesFittingBelow[(size_t)upperSlot][piece][(size_t)lowerSlot];
+		return result;
+	}
+}
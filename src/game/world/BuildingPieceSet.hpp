@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <vector>
 
 #include "Chunk.hpp"
@@ -7,6 +9,17 @@
 
 namespace game::world
 {
+	// The directions in which a building piece can have neighboring pieces.
+	enum class BuildingPieceDirection : uint8_t
+	{
+		LEFT,
+		RIGHT,
+		FRONT,
+		BACK,
+		UP,
+		DOWN
+	};
+
 	class BuildingPiece
 	{
 	public:
@@ -68,6 +81,25 @@ namespace game::world
 			return fitsDown;
 		}
 
+		const std::vector<std::string>& getFits(BuildingPieceDirection direction)
+		{
+			switch (direction)
+			{
+			case BuildingPieceDirection::LEFT:
+				return fitsLeft;
+			case BuildingPieceDirection::RIGHT:
+				return fitsRight;
+			case BuildingPieceDirection::FRONT:
+				return fitsFront;
+			case BuildingPieceDirection::BACK:
+				return fitsBack;
+			case BuildingPieceDirection::UP:
+				return fitsUp;
+			default:
+				return fitsDown;
+			}
+		}
+
 	private:
 		std::string id;
 		std::shared_ptr<rendering::model::MeshData> meshData;
@@ -168,6 +200,144 @@ namespace game::world
 		) {}
 	};
 
+	// The different kinds of pieces a building can be assembled of. NONE means that no piece needs to be placed.
+	enum class BuildingPieceSlot : uint8_t
+	{
+		NONE,
+		STRAIGHT_EDGE_WALL,
+		STRAIGHT_EDGE_WALL_ROOF_OUTER_CORNER,
+		STRAIGHT_EDGE_ROOF_WALL_INNER_CORNER,
+		STRAIGHT_EDGE_WALL_ROOF_LEFT,
+		STRAIGHT_EDGE_WALL_ROOF_RIGHT,
+		INNER_CORNER_WALL,
+		INNER_CORNER_WALL_ROOF_OUTER_CORNER,
+		INNER_CORNER_ROOF_WALL_INNER_CORNER,
+		INNER_CORNER_WALL_ROOF_LEFT,
+		INNER_CORNER_WALL_ROOF_RIGHT,
+		INNER_CORNER_WALL_ROOF_BOTH,
+		OUTER_CORNER_WALL,
+		OUTER_CORNER_WALL_ROOF_OUTER_CORNER,
+		OUTER_CORNER_ROOF_WALL_INNER_CORNER,
+		NO_EDGE_ROOF,
+		AMOUNT_OF_SLOTS
+	};
+
+	constexpr size_t AMOUNT_OF_BUILDING_PIECE_SLOTS = (size_t)BuildingPieceSlot::AMOUNT_OF_SLOTS;
+
+	// Bits of the occupancy configuration of the cube spanned by a cell's floor and one of the cell's faces. The lower
+	// corner of the cell itself is always occupied (otherwise there wouldn't be any pieces to place), so it isn't part of
+	// the configuration. The neighbors are named by their position within the face relative to the cell.
+	constexpr uint8_t OCCUPIED_CELL_UP = 1 << 0;
+	constexpr uint8_t OCCUPIED_COUNTER_CLOCKWISE_DOWN = 1 << 1;
+	constexpr uint8_t OCCUPIED_COUNTER_CLOCKWISE_UP = 1 << 2;
+	constexpr uint8_t OCCUPIED_DIAGONAL_DOWN = 1 << 3;
+	constexpr uint8_t OCCUPIED_DIAGONAL_UP = 1 << 4;
+	constexpr uint8_t OCCUPIED_CLOCKWISE_DOWN = 1 << 5;
+	constexpr uint8_t OCCUPIED_CLOCKWISE_UP = 1 << 6;
+	constexpr size_t AMOUNT_OF_OCCUPANCY_CONFIGURATIONS = 1 << 7;
+
+	// The pieces to place within the lower and upper half of a floor and the half of the cube they must be placed in.
+	struct BuildingPieceSelection
+	{
+		BuildingPieceSlot lowerPiece{ BuildingPieceSlot::NONE };
+		BuildingPieceSlot upperPiece{ BuildingPieceSlot::NONE };
+		bool onRightHalf{ false };
+	};
+
+	constexpr BuildingPieceSelection selectBuildingPieces(uint8_t occupancy)
+	{
+		bool occupiedCellUp = occupancy & OCCUPIED_CELL_UP;
+		bool occupiedCounterClockwiseDown = occupancy & OCCUPIED_COUNTER_CLOCKWISE_DOWN;
+		bool occupiedCounterClockwiseUp = occupancy & OCCUPIED_COUNTER_CLOCKWISE_UP;
+		bool occupiedDiagonalDown = occupancy & OCCUPIED_DIAGONAL_DOWN;
+		bool occupiedDiagonalUp = occupancy & OCCUPIED_DIAGONAL_UP;
+		bool occupiedClockwiseDown = occupancy & OCCUPIED_CLOCKWISE_DOWN;
+		bool occupiedClockwiseUp = occupancy & OCCUPIED_CLOCKWISE_UP;
+
+		// Determine whether we must place a straight edge piece, an outer corner piece, an inner corner piece or a
+		// no edge piece. Exactly one of these is true for each half of the floor.
+		bool straightEdgeDown = occupiedClockwiseDown != occupiedCounterClockwiseDown;
+		bool straightEdgeUp = occupiedClockwiseUp != occupiedCounterClockwiseUp;
+		bool outerCornerDown = !occupiedClockwiseDown && !occupiedCounterClockwiseDown;
+		bool outerCornerUp = !occupiedClockwiseUp && !occupiedCounterClockwiseUp;
+		bool innerCornerDown = occupiedClockwiseDown && occupiedCounterClockwiseDown && !occupiedDiagonalDown;
+		bool innerCornerUp = occupiedClockwiseUp && occupiedCounterClockwiseUp && !occupiedDiagonalUp;
+		bool noEdgeDown = occupiedClockwiseDown && occupiedCounterClockwiseDown && occupiedDiagonalDown;
+
+		BuildingPieceSelection selection;
+		selection.onRightHalf = straightEdgeDown && occupiedClockwiseDown || !straightEdgeDown && !noEdgeDown
+			|| noEdgeDown && (straightEdgeUp && occupiedClockwiseUp || !straightEdgeUp);
+
+		if (straightEdgeDown)
+		{
+			selection.lowerPiece = BuildingPieceSlot::STRAIGHT_EDGE_WALL;
+			if (!occupiedCellUp)
+				selection.upperPiece = BuildingPieceSlot::STRAIGHT_EDGE_WALL_ROOF_OUTER_CORNER;
+			else if (outerCornerUp && selection.onRightHalf)
+				selection.upperPiece = BuildingPieceSlot::STRAIGHT_EDGE_WALL_ROOF_RIGHT;
+			else if (outerCornerUp)
+				selection.upperPiece = BuildingPieceSlot::STRAIGHT_EDGE_WALL_ROOF_LEFT;
+			else
+				selection.upperPiece = BuildingPieceSlot::STRAIGHT_EDGE_WALL;
+		}
+		else if (outerCornerDown)
+		{
+			selection.lowerPiece = BuildingPieceSlot::OUTER_CORNER_WALL;
+			if (!occupiedCellUp)
+				selection.upperPiece = BuildingPieceSlot::OUTER_CORNER_WALL_ROOF_OUTER_CORNER;
+			else
+				selection.upperPiece = BuildingPieceSlot::OUTER_CORNER_WALL;
+		}
+		else if (innerCornerDown)
+		{
+			selection.lowerPiece = BuildingPieceSlot::INNER_CORNER_WALL;
+			if (!occupiedCellUp)
+				selection.upperPiece = BuildingPieceSlot::INNER_CORNER_WALL_ROOF_OUTER_CORNER;
+			else if (straightEdgeUp && occupiedCounterClockwiseUp)
+				selection.upperPiece = BuildingPieceSlot::INNER_CORNER_WALL_ROOF_RIGHT;
+			else if (straightEdgeUp && occupiedClockwiseUp)
+				selection.upperPiece = BuildingPieceSlot::INNER_CORNER_WALL_ROOF_LEFT;
+			else if (outerCornerUp)
+				selection.upperPiece = BuildingPieceSlot::INNER_CORNER_WALL_ROOF_BOTH;
+			else
+				selection.upperPiece = BuildingPieceSlot::INNER_CORNER_WALL;
+		}
+		else
+		{
+			// There is no edge in the lower half, so there is no wall to place.
+			if (!occupiedCellUp)
+				selection.upperPiece = BuildingPieceSlot::NO_EDGE_ROOF;
+			else if (straightEdgeUp)
+				selection.upperPiece = BuildingPieceSlot::STRAIGHT_EDGE_ROOF_WALL_INNER_CORNER;
+			else if (outerCornerUp)
+				selection.upperPiece = BuildingPieceSlot::OUTER_CORNER_ROOF_WALL_INNER_CORNER;
+			else if (innerCornerUp)
+				selection.upperPiece = BuildingPieceSlot::INNER_CORNER_ROOF_WALL_INNER_CORNER;
+		}
+
+		return selection;
+	}
+
+	constexpr std::array<BuildingPieceSelection, AMOUNT_OF_OCCUPANCY_CONFIGURATIONS> generateBuildingPieceSelectionTable()
+	{
+		std::array<BuildingPieceSelection, AMOUNT_OF_OCCUPANCY_CONFIGURATIONS> table{};
+		for (size_t occupancy = 0; occupancy < AMOUNT_OF_OCCUPANCY_CONFIGURATIONS; occupancy++)
+			table[occupancy] = selectBuildingPieces((uint8_t)occupancy);
+		return table;
+	}
+
+	// The pieces to place for each occupancy configuration (i.e. the marching cubes lookup table of the buildings).
+	constexpr std::array<BuildingPieceSelection, AMOUNT_OF_OCCUPANCY_CONFIGURATIONS> BUILDING_PIECE_SELECTION_TABLE =
+		generateBuildingPieceSelectionTable();
+
+	// A set of pieces of a single slot. Bit i is set if the i-th piece of the slot is (still) possible.
+	using BuildingPieceDomain = uint64_t;
+	constexpr size_t MAX_BUILDING_PIECES_PER_SLOT = 64;
+
+	// The amount of different solutions per column of slots. Each column picks one of them based on its cell and face, so
+	// that rebuilding a column always results in the same pieces while neighboring columns still look different.
+	constexpr size_t AMOUNT_OF_BUILDING_PIECE_VARIANTS = 4;
+
 	class BuildingPieceSet
 	{
 	public:
@@ -201,7 +371,40 @@ namespace game::world
 			outerCornerWallPieces(_outerCornerWallPieces),
 			outerCornerWallRoofOuterCornerPieces(_outerCornerWallRoofOuterCornerPieces),
 			outerCornerRoofWallInnerCornerPieces(_outerCornerRoofWallInnerCornerPieces),
-			noEdgeRoofPieces(_noEdgeRoofPieces) {}
+			noEdgeRoofPieces(_noEdgeRoofPieces),
+			piecesPerSlot{
+				std::vector<std::shared_ptr<BuildingPiece>>(),
+				toPieces(_straightEdgeWallPieces),
+				toPieces(_straightEdgeWallRoofOuterCornerPieces),
+				toPieces(_straightEdgeRoofWallInnerCornerPieces),
+				toPieces(_straightEdgeWallRoofLeftPieces),
+				toPieces(_straightEdgeWallRoofRightPieces),
+				toPieces(_innerCornerWallPieces),
+				toPieces(_innerCornerWallRoofOuterCornerPieces),
+				toPieces(_innerCornerRoofWallInnerCornerPieces),
+				toPieces(_innerCornerWallRoofLeftPieces),
+				toPieces(_innerCornerWallRoofRightPieces),
+				toPieces(_innerCornerWallRoofBothPieces),
+				toPieces(_outerCornerWallPieces),
+				toPieces(_outerCornerWallRoofOuterCornerPieces),
+				toPieces(_outerCornerRoofWallInnerCornerPieces),
+				toPieces(_noEdgeRoofPieces)
+			}
+		{
+			createPieceDomains();
+		}
+
+		const std::vector<std::shared_ptr<BuildingPiece>>& getPieces(BuildingPieceSlot slot)
+		{
+			return piecesPerSlot[(size_t)slot];
+		}
+
+		// Chooses a piece for each slot of a column of stacked slots (ordered from bottom to top, NONE if there is no piece
+		// to place) such that vertically adjacent pieces fit each other. Returns the index of the chosen piece within its
+		// slot for each slot of the column. Only the vertical rules are used, as the columns of the neighboring faces are
+		// solved independently of each other. The solver doesn't modify the piece set, so it can be shared by worlds
+		// running on different threads.
+		std::vector<uint8_t> solveColumn(const std::vector<BuildingPieceSlot>& slots, size_t variant) const;
 
 		const std::vector<std::shared_ptr<StraightEdgeBuildingPiece>>& getStraightEdgeWallPieces()
 		{
@@ -297,6 +500,37 @@ namespace game::world
 		std::vector<std::shared_ptr<OuterCornerBuildingPiece>> outerCornerRoofWallInnerCornerPieces;
 
 		std::vector<std::shared_ptr<NoEdgeBuildingPiece>> noEdgeRoofPieces;
+
+		// The pieces of all slots (in the order of BuildingPieceSlot) for looking them up by their slot.
+		std::array<std::vector<std::shared_ptr<BuildingPiece>>, AMOUNT_OF_BUILDING_PIECE_SLOTS> piecesPerSlot;
+
+		// The vertical adjacency rules of the pieces as bitsets, i.e. piecesFittingAbove[slot][piece][otherSlot] are the
+		// pieces of the other slot which may be placed above the piece (and piecesFittingBelow likewise below it). The
+		// horizontal rules aren't stored, as solveColumn doesn't use them.
+		using PieceAdjacency = std::array<BuildingPieceDomain, AMOUNT_OF_BUILDING_PIECE_SLOTS>;
+		std::array<std::vector<PieceAdjacency>, AMOUNT_OF_BUILDING_PIECE_SLOTS> piecesFittingAbove;
+		std::array<std::vector<PieceAdjacency>, AMOUNT_OF_BUILDING_PIECE_SLOTS> piecesFittingBelow;
+		std::array<BuildingPieceDomain, AMOUNT_OF_BUILDING_PIECE_SLOTS> allPiecesPerSlot;
+		bool hasVariants{ false };
+
+		// The pieces of the lower slot which fit at least one piece of the upper slot placed above them, i.e.
+		// piecesSupportedFromAbove[lowerSlot][upperSlot].
+		std::array<std::array<BuildingPieceDomain, AMOUNT_OF_BUILDING_PIECE_SLOTS>, AMOUNT_OF_BUILDING_PIECE_SLOTS> piecesSupportedFromAbove;
+
+		void createPieceDomains();
+
+		// Returns the pieces of the lower slot which fit below at least one of the given pieces of the upper slot.
+		BuildingPieceDomain getPiecesFittingBelow(
+			BuildingPieceSlot upperSlot,
+			BuildingPieceDomain upperPieces,
+			BuildingPieceSlot lowerSlot
+		) const;
+
+		template <class PieceType>
+		static std::vector<std::shared_ptr<BuildingPiece>> toPieces(const std::vector<std::shared_ptr<PieceType>>& pieces)
+		{
+			return std::vector<std::shared_ptr<BuildingPiece>>(pieces.begin(), pieces.end());
+		}
 	};
 
 	struct BuildingHeight
@@ -314,10 +548,11 @@ namespace game::world
 	{
 	public:
 		IBuilding(
+			CellContentTypeId _contentTypeId,
 			std::string& _typeName,
 			std::string& _description,
 			std::shared_ptr<BuildingPieceSet> _buildingPieceSet
-		) : IBuilding(_typeName, _description, _buildingPieceSet, nullptr, std::unordered_set<Cell*>()) {}
+		) : IBuilding(_contentTypeId, _typeName, _description, _buildingPieceSet, nullptr, std::unordered_set<Cell*>()) {}
 
 		virtual ~IBuilding() {}
 
@@ -341,12 +576,8 @@ namespace game::world
 				height = found->second.actualHeight;
 
 			Inventory result = Inventory();
-			for (const std::shared_ptr<IItem>& item : resourcesPerHeight.items)
-			{
-				std::shared_ptr<IItem> clonedItem = item->clone();
-				clonedItem->amount *= height;
-				result.items.insert(clonedItem);
-			}
+			for (size_t i = 0; i < AMOUNT_OF_ITEM_TYPES; i++)
+				result.amounts[i] = resourcesPerHeight.amounts[i] * height;
 			return result;
 		}
 
@@ -380,12 +611,13 @@ namespace game::world
 		std::unordered_map<Cell*, BuildingHeight> heightPerCell;
 
 		IBuilding(
+			CellContentTypeId _contentTypeId,
 			const std::string& _typeName,
 			const std::string& _description,
 			std::shared_ptr<BuildingPieceSet> _buildingPieceSet,
 			IBuilding* original,
 			std::unordered_set<Cell*> cellsToCopy
-		) : CellContent(true, _typeName, _description), buildingPieceSet(_buildingPieceSet)
+		) : CellContent(true, _contentTypeId, _typeName, _description), buildingPieceSet(_buildingPieceSet)
 		{
 			if (original != nullptr)
 			{
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace game::world
+{
+	class Tree;
+	class Rock;
+	class DroneFactoryBuilding;
+	class FoodFactoryBuilding;
+	class MineBuilding;
+	class ReforesterBuilding;
+	class ResidenceBuilding;
+	class StorageBuilding;
+	class WoodcutterBuilding;
+	class TestBuilding;
+	class OtherTestBuilding;
+
+	template <class... Types>
+	struct CellContentTypeList
+	{
+		static constexpr size_t size = sizeof...(Types);
+	};
+
+	// All types of cell contents known to the game. Each cell content stores the position of its type in this list as a
+	// compact type tag, so that checking the type of a cell content doesn't require a dynamic_cast. New resource and
+	// building types must be added here.
+	using RegisteredCellContentTypes = CellContentTypeList<
+		Tree,
+		Rock,
+		DroneFactoryBuilding,
+		FoodFactoryBuilding,
+		MineBuilding,
+		ReforesterBuilding,
+		ResidenceBuilding,
+		StorageBuilding,
+		WoodcutterBuilding,
+		TestBuilding,
+		OtherTestBuilding
+	>;
+
+	constexpr size_t AMOUNT_OF_CELL_CONTENT_TYPES = RegisteredCellContentTypes::size;
+
+	using CellContentTypeId = uint8_t;
+
+	static_assert(AMOUNT_OF_CELL_CONTENT_TYPES <= 256, "Too many cell content types for an 8 bit type tag!");
+
+	template <class T, class List>
+	struct CellContentTypeIndex;
+
+	template <class T, class... Types>
+	struct CellContentTypeIndex<T, CellContentTypeList<T, Types...>> : std::integral_constant<CellContentTypeId, 0> {};
+
+	template <class T, class First, class... Types>
+	struct CellContentTypeIndex<T, CellContentTypeList<First, Types...>>
+		: std::integral_constant<CellContentTypeId, 1 + CellContentTypeIndex<T, CellContentTypeList<Types...>>::value> {};
+
+	template <class T>
+	constexpr CellContentTypeId cellContentTypeId = CellContentTypeIndex<T, RegisteredCellContentTypes>::value;
+}
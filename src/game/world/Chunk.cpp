@@ -43,6 +43,12 @@ namespace game::world
 		entt::registry& _registry,
 		rendering::shading::Shader* _terrainShader,
 		rendering::shading::Shader* _waterShader,
+		rendering::shading::Shader* _buildingShader,
+		rendering::shading::Shader* _buildingShadowShader,
+		rendering::shading::Shader* _buildingPickingShader,
+		rendering::shading::Shader* _instancedShader,
+		rendering::shading::Shader* _instancedShadowShader,
+		rendering::shading::Shader* _instancedPickingShader,
 		int _chunkSize,
 		float _cellSize
 	) :
@@ -52,6 +58,12 @@ namespace game::world
 		registry(_registry),
 		terrainShader(_terrainShader),
 		waterShader(_waterShader),
+		buildingShader(_buildingShader),
+		buildingShadowShader(_buildingShadowShader),
+		buildingPickingShader(_buildingPickingShader),
+		instancedShader(_instancedShader),
+		instancedShadowShader(_instancedShadowShader),
+		instancedPickingShader(_instancedPickingShader),
 		chunkSize(_chunkSize),
 		cellSize(_cellSize),
 		numCellsAlongOneChunkEdge(2 * chunkSize),
@@ -65,8 +77,7 @@ namespace game::world
 		chunkHorizontalDistance(chunkWidth),
 		chunkVerticalDistance(0.75f * chunkHeight),
 		topologyMesh(nullptr),
-		landscapeMesh(nullptr),
-		cellContentMesh(nullptr)
+		landscapeMesh(nullptr)
 	{
 		centerPos = (float)column * columnDirection + (float)row * rowDirection;
 
@@ -105,6 +116,12 @@ namespace game::world
 		cullingEntity = registry.create();
 		registry.emplace<rendering::components::CullingGeometry>(cullingEntity, cullingGeometry);
 
+		cellHighlightStatusTexture = std::make_shared<rendering::model::BufferTexture>(
+			GL_R8UI,
+			&cellHighlightStatuses[0],
+			sizeof(cellHighlightStatuses)
+		);
+
 		if (ADD_TOPOLOGY_MESH)
 		{
 			// Add an entity for the chunk's topology mesh.
@@ -126,6 +143,7 @@ namespace game::world
 			// Add an entity for the chunk's landscape mesh.
 			landscapeEntity = registry.create();
 			rendering::model::Mesh* mesh = getLandscapeMesh();
+			mesh->setLookupData(cellHighlightStatusTexture);
 			registry.emplace<rendering::components::MeshRenderer>(landscapeEntity, mesh);
 			registry.emplace<rendering::components::CullingGeometry>(landscapeEntity, mesh->getBoundingGeometry());
 			registry.emplace<rendering::components::MatrixTransform>(
@@ -169,10 +187,16 @@ namespace game::world
 				rendering::systems::cullingRelationship(registry, cullingEntity, waterEntity);
 			}
 		}
+
+		// Cells whose content was changed before the chunk was added to the world weren't updated yet.
+		if (!cellsWithChangedContent.empty())
+			registry.emplace_or_replace<ChunkUpdate>(cullingEntity, this);
 	}
 
-	void Chunk::enqueueUpdate()
+	void Chunk::enqueueUpdate(Cell* cell)
 	{
+		cellsWithChangedContent.insert(cell);
+
 		if (cullingEntity == entt::null || !registry.valid(cullingEntity))
 		{
 			// Chunk was not added to the world yet. There's no need to do anything at all.
@@ -182,6 +206,15 @@ namespace game::world
 		registry.emplace_or_replace<ChunkUpdate>(cullingEntity, this);
 	}
 
+	void Chunk::setHighlightStatus(Cell* cell, CellHighlightStatus highlightStatus)
+	{
+		cellHighlightStatuses[cell->cellId] = highlightStatus;
+
+		// Chunks which weren't added to the world yet upload all highlight statuses once they are added.
+		if (cellHighlightStatusTexture != nullptr)
+			cellHighlightStatusTexture->setSubData(cell->cellId, &cellHighlightStatuses[cell->cellId], sizeof(CellHighlightStatus));
+	}
+
 	void Chunk::update()
 	{
 		if (cullingEntity == entt::null)
@@ -190,90 +223,271 @@ namespace game::world
 			return;
 		}
 
-		if (cellContentEntity == entt::null)
-			cellContentEntity = registry.create();
+		// Only the instances belonging to cells whose content has changed need to be rebuilt.
+		for (Cell* cell : cellsWithChangedContent)
+		{
+			updateTransformedMeshInstance(cell);
+			updateDeformedMeshInstances(cell);
+		}
+		cellsWithChangedContent.clear();
+	}
 
-		std::map<std::shared_ptr<rendering::model::MeshData>, std::vector<rendering::model::MeshDataInstance>> instancesPerMesh;
-		for (const auto& cell : cells)
+	void Chunk::updateDeformedMeshInstances(Cell* cell)
+	{
+		std::vector<std::pair<std::shared_ptr<rendering::model::MeshData>, DeformedMeshInstance>> instances;
+		CellContent* content = cell->content;
+		if (content != nullptr && content->getCells().find(cell)->second.hasDeformedMeshInstances)
+			content->createDeformedMeshInstances(cell, instances);
+
+		// The instances of each mesh must be contiguous, so that they fit into a single range.
+		std::stable_sort(instances.begin(), instances.end(), [](const auto& a, const auto& b) {
+			return a.first.get() < b.first.get();
+		});
+
+		std::vector<DeformedMeshRange> oldRanges;
+		auto foundRanges = deformedMeshRanges.find(cell);
+		if (foundRanges != deformedMeshRanges.end())
 		{
-			CellContent* content = cell.second->content;
-			if (content != nullptr)
-			{
-				CellContentCellData cellData = content->getCells().find(cell.second)->second;
-				if (cellData.meshData != nullptr)
-				{
-					glm::mat4 transform = cellData.transform.getTransform();
+			oldRanges = std::move(foundRanges->second);
+			deformedMeshRanges.erase(foundRanges);
+		}
 
-					auto cellIds = std::make_shared<rendering::model::VertexAttribute<glm::uvec2>>(
-						2,
-						rendering::model::VertexAttributeType::INTEGER,
-						GL_UNSIGNED_INT
-					);
+		std::vector<DeformedMeshRange> ranges;
+		for (size_t first = 0; first < instances.size();)
+		{
+			size_t last = first;
+			while (last < instances.size() && instances[last].first == instances[first].first)
+				last++;
 
-					bool meshDataHasCellIds = false;
-					auto& found = cellData.meshData->additionalVertexAttributes.find(CELL_ID_ATTRIBUTE_LOCATION);
-					if (found != cellData.meshData->additionalVertexAttributes.end())
-					{
-						auto attributeCasted = std::dynamic_pointer_cast<rendering::model::VertexAttribute<glm::uvec2>>(found->second);
-						if (attributeCasted != nullptr)
-						{
-							meshDataHasCellIds = true;
-							for (size_t i = 0; i < attributeCasted->attributeData.size(); i++)
-								attributeCasted->attributeData[i].x = cell.second->completeId;
-						}
-					}
+			DeformedMesh& deformedMesh = getDeformedMesh(instances[first].first);
+			ranges.push_back(DeformedMeshRange{ &deformedMesh, 0, last - first });
+			first = last;
+		}
 
-					if (!meshDataHasCellIds)
-						for (size_t i = 0; i < cellData.meshData->vertices.size(); i++)
-							cellIds->attributeData.push_back(glm::uvec2(cell.second->completeId, cellData.highlightStatus));
+		// Ranges of meshes which are no longer used by the cell or whose amount of instances changed are freed first, so
+		// that they can be reused right away. Ranges of the same size are overwritten in place.
+		std::vector<bool> reusedRanges(ranges.size(), false);
+		for (const DeformedMeshRange& oldRange : oldRanges)
+		{
+			auto reused = std::find_if(ranges.begin(), ranges.end(), [&oldRange](const DeformedMeshRange& range) {
+				return range.deformedMesh == oldRange.deformedMesh && range.size == oldRange.size;
+			});
+			if (reused == ranges.end())
+			{
+				freeDeformedMeshRange(oldRange);
+				continue;
+			}
+
+			reused->offset = oldRange.offset;
+			reusedRanges[reused - ranges.begin()] = true;
+			oldRange.deformedMesh->amountOfUsedInstances -= oldRange.size;
+		}
+
+		size_t instanceIndex = 0;
+		for (size_t i = 0; i < ranges.size(); i++)
+		{
+			DeformedMeshRange& range = ranges[i];
+			DeformedMesh& deformedMesh = *range.deformedMesh;
+			if (!reusedRanges[i])
+				range.offset = deformedMesh.allocator.allocate(range.size);
+			if (deformedMesh.instances.size() < deformedMesh.allocator.getCapacity())
+				deformedMesh.instances.resize(deformedMesh.allocator.getCapacity(), DeformedMeshInstance{});
+
+			std::vector<glm::vec3> corners;
+			corners.reserve(8 * range.size + 8);
+			for (size_t j = 0; j < range.size; j++, instanceIndex++)
+			{
+				DeformedMeshInstance& instance = instances[instanceIndex].second;
+				instance.cellId = cell->completeId;
+				deformedMesh.instances[range.offset + j] = instance;
 
-					std::unordered_map<GLuint, std::shared_ptr<rendering::model::IVertexAttribute>> additionalVertexAttributes;
-					additionalVertexAttributes.insert(std::make_pair(CELL_ID_ATTRIBUTE_LOCATION, cellIds));
-					instancesPerMesh[cellData.meshData].push_back(rendering::model::MeshDataInstance(transform, additionalVertexAttributes));
+				for (float height : { instance.lowerHeight, instance.upperHeight })
+				{
+					corners.push_back(glm::vec3(instance.frontLeft.x, height, instance.frontLeft.y));
+					corners.push_back(glm::vec3(instance.frontRight.x, height, instance.frontRight.y));
+					corners.push_back(glm::vec3(instance.backLeft.x, height, instance.backLeft.y));
+					corners.push_back(glm::vec3(instance.backRight.x, height, instance.backRight.y));
 				}
 			}
+			deformedMesh.mesh->setInstanceSubData(deformedMesh.instances, range.offset, range.size);
+
+			// The bounding geometry of the mesh must contain the deformed instances instead of the mesh data itself. It isn't
+			// shrunk, as this would require to look at all remaining instances.
+			auto boundingGeometry = deformedMesh.mesh->getBoundingGeometry();
+			if (deformedMesh.amountOfUsedInstances > 0)
+			{
+				std::vector<glm::vec3> extremaPoints = boundingGeometry->getExtremaPoints();
+				corners.insert(corners.end(), extremaPoints.begin(), extremaPoints.end());
+			}
+			boundingGeometry->fitToVertices(corners);
+			deformedMesh.amountOfUsedInstances += range.size;
+
+			registry.emplace_or_replace<rendering::components::MeshRenderer>(deformedMesh.entity, deformedMesh.mesh);
+			cullingGeometry->extendToFitGeometry(boundingGeometry);
 		}
 
-		std::vector<std::pair<std::shared_ptr<rendering::model::MeshData>, std::vector<rendering::model::MeshDataInstance>>> instances;
-		for (const auto& meshAndInstances : instancesPerMesh)
-			instances.push_back(meshAndInstances);
+		if (!ranges.empty())
+			deformedMeshRanges.insert(std::make_pair(cell, std::move(ranges)));
+	}
 
-		if (cellContentMesh == nullptr)
-		{
-			if (instances.empty())
-				return;
+	void Chunk::freeDeformedMeshRange(const DeformedMeshRange& range)
+	{
+		if (range.size == 0)
+			return;
 
-			cellContentMesh = new rendering::model::Mesh(
-				instances, 
-				std::make_shared<rendering::bounding_geometry::AABB>(new rendering::bounding_geometry::AABB::WorldSpace)
-			);
-			registry.emplace<rendering::components::MeshRenderer>(cellContentEntity, cellContentMesh);
-			registry.emplace<rendering::components::CullingGeometry>(cellContentEntity, cellContentMesh->getBoundingGeometry());
-			registry.emplace<rendering::components::MatrixTransform>(
-				cellContentEntity,
-				rendering::components::EulerComponentwiseTransform().toTransformationMatrix()
-			);
+		DeformedMesh& deformedMesh = *range.deformedMesh;
+		std::fill_n(deformedMesh.instances.begin() + range.offset, range.size, DeformedMeshInstance{});
+		deformedMesh.mesh->setInstanceSubData(deformedMesh.instances, range.offset, range.size);
+		deformedMesh.allocator.free(range.offset, range.size);
 
-			cullingGeometry->extendToFitGeometry(cellContentMesh->getBoundingGeometry());
-			rendering::systems::cullingRelationship(registry, cullingEntity, cellContentEntity);
+		// Meshes without any instances left don't need to be rendered anymore.
+		deformedMesh.amountOfUsedInstances -= range.size;
+		if (deformedMesh.amountOfUsedInstances == 0)
+			registry.remove_if_exists<rendering::components::MeshRenderer>(deformedMesh.entity);
+	}
+
+	Chunk::DeformedMesh& Chunk::getDeformedMesh(const std::shared_ptr<rendering::model::MeshData>& meshData)
+	{
+		auto found = deformedMeshes.find(meshData);
+		if (found != deformedMeshes.end())
+			return found->second;
+
+		// Upload the mesh data once per chunk. All instances within this chunk are rendered by a single entity.
+		DeformedMesh deformedMesh;
+		deformedMesh.mesh = new rendering::model::Mesh(
+			*meshData,
+			std::make_shared<rendering::bounding_geometry::AABB>(new rendering::bounding_geometry::AABB::WorldSpace)
+		);
+		deformedMesh.mesh->setLookupData(cellHighlightStatusTexture);
+
+		deformedMesh.entity = registry.create();
+		registry.emplace<rendering::components::CullingGeometry>(deformedMesh.entity, deformedMesh.mesh->getBoundingGeometry());
+		registry.emplace<rendering::components::MatrixTransform>(
+			deformedMesh.entity,
+			rendering::components::EulerComponentwiseTransform().toTransformationMatrix()
+		);
+		rendering::systems::cullingRelationship(registry, cullingEntity, deformedMesh.entity);
+
+		auto& shading = registry.ctx<rendering::systems::MeshShading>();
+		shading.shaders.insert(std::make_pair(deformedMesh.mesh, buildingShader));
+
+		auto& shadows = registry.ctx<rendering::systems::ShadowMapping>();
+		shadows.castShadow.insert(std::make_pair(deformedMesh.mesh, RESSOURCE_SHADOW_LVL));
+		shadows.shaders.insert(std::make_pair(deformedMesh.mesh, buildingShadowShader));
+
+		auto& picking = registry.ctx<rendering::systems::Picking>();
+		picking.shaders.insert(std::make_pair(deformedMesh.mesh, buildingPickingShader));
 
-			auto& shadows = registry.ctx<rendering::systems::ShadowMapping>();
-			shadows.castShadow.insert(std::make_pair(cellContentMesh, RESSOURCE_SHADOW_LVL));
+		return deformedMeshes.insert(std::make_pair(meshData, std::move(deformedMesh))).first->second;
+	}
+
+	void Chunk::updateTransformedMeshInstance(Cell* cell)
+	{
+		std::shared_ptr<rendering::model::MeshData> meshData = nullptr;
+		TransformedMeshInstance instance{};
+		if (cell->content != nullptr)
+		{
+			const CellContentCellData& cellData = cell->content->getCells().find(cell)->second;
+			meshData = cellData.instancedMeshData;
+			instance.transform = cellData.transform.getTransform();
+			instance.cellId = cell->completeId;
 		}
-		else
+
+		auto slot = transformedMeshSlots.find(cell);
+		if (slot != transformedMeshSlots.end() && (meshData == nullptr || slot->second.first != &getTransformedMesh(meshData)))
 		{
-			if (instances.empty())
+			// Remove the old instance by moving the last instance of its mesh into its slot.
+			TransformedMesh& transformedMesh = *slot->second.first;
+			size_t freedSlot = slot->second.second;
+			transformedMeshSlots.erase(slot);
+
+			transformedMesh.instances[freedSlot] = transformedMesh.instances.back();
+			transformedMesh.cellPerSlot[freedSlot] = transformedMesh.cellPerSlot.back();
+			transformedMesh.instances.pop_back();
+			transformedMesh.cellPerSlot.pop_back();
+
+			if (freedSlot < transformedMesh.instances.size())
 			{
-				registry.remove_if_exists<rendering::components::MeshRenderer>(cellContentEntity);
+				transformedMeshSlots[transformedMesh.cellPerSlot[freedSlot]].second = freedSlot;
+				transformedMesh.mesh->setInstanceSubData(transformedMesh.instances, freedSlot, 1);
 			}
 			else
 			{
-				cellContentMesh->setData(instances);
-				registry.emplace_or_replace<rendering::components::MeshRenderer>(cellContentEntity, cellContentMesh);
-				registry.get<rendering::components::CullingGeometry>(cellContentEntity).boundingGeometry = cellContentMesh->getBoundingGeometry();
-				cullingGeometry->extendToFitGeometry(cellContentMesh->getBoundingGeometry());
+				transformedMesh.mesh->setInstanceSubData(transformedMesh.instances, 0, 0);
 			}
+
+			// The bounding geometry isn't shrunk, as this would require to look at all remaining instances.
+			if (transformedMesh.instances.empty())
+				registry.remove_if_exists<rendering::components::MeshRenderer>(transformedMesh.entity);
+
+			slot = transformedMeshSlots.end();
+		}
+
+		if (meshData == nullptr)
+			return;
+
+		TransformedMesh& transformedMesh = getTransformedMesh(meshData);
+		if (slot == transformedMeshSlots.end())
+		{
+			slot = transformedMeshSlots.insert(std::make_pair(cell, std::make_pair(&transformedMesh, transformedMesh.instances.size()))).first;
+			transformedMesh.instances.push_back(instance);
+			transformedMesh.cellPerSlot.push_back(cell);
+		}
+		else
+		{
+			transformedMesh.instances[slot->second.second] = instance;
 		}
+		transformedMesh.mesh->setInstanceSubData(transformedMesh.instances, slot->second.second, 1);
+
+		// The bounding geometry of the mesh must contain the transformed instances instead of the mesh data itself.
+		auto instanceBoundingGeometry = transformedMesh.meshDataBoundingGeometry->toWorldSpace(instance.transform);
+		auto boundingGeometry = transformedMesh.mesh->getBoundingGeometry();
+		if (transformedMesh.instances.size() == 1)
+			boundingGeometry->fitToVertices(instanceBoundingGeometry->getExtremaPoints());
+		else
+			boundingGeometry->extendToFitGeometry(instanceBoundingGeometry);
+
+		registry.emplace_or_replace<rendering::components::MeshRenderer>(transformedMesh.entity, transformedMesh.mesh);
+		cullingGeometry->extendToFitGeometry(boundingGeometry);
+	}
+
+	Chunk::TransformedMesh& Chunk::getTransformedMesh(const std::shared_ptr<rendering::model::MeshData>& meshData)
+	{
+		auto found = transformedMeshes.find(meshData);
+		if (found != transformedMeshes.end())
+			return found->second;
+
+		// Upload the mesh data once per chunk. All instances within this chunk are rendered by a single entity.
+		TransformedMesh transformedMesh;
+		transformedMesh.mesh = new rendering::model::Mesh(
+			*meshData,
+			std::make_shared<rendering::bounding_geometry::AABB>(new rendering::bounding_geometry::AABB::WorldSpace)
+		);
+		transformedMesh.meshDataBoundingGeometry = std::make_shared<rendering::bounding_geometry::AABB>(
+			meshData->vertices,
+			new rendering::bounding_geometry::AABB::ObjectSpace
+		);
+		transformedMesh.mesh->setLookupData(cellHighlightStatusTexture);
+
+		transformedMesh.entity = registry.create();
+		registry.emplace<rendering::components::CullingGeometry>(transformedMesh.entity, transformedMesh.mesh->getBoundingGeometry());
+		registry.emplace<rendering::components::MatrixTransform>(
+			transformedMesh.entity,
+			rendering::components::EulerComponentwiseTransform().toTransformationMatrix()
+		);
+		rendering::systems::cullingRelationship(registry, cullingEntity, transformedMesh.entity);
+
+		auto& shading = registry.ctx<rendering::systems::MeshShading>();
+		shading.shaders.insert(std::make_pair(transformedMesh.mesh, instancedShader));
+
+		auto& shadows = registry.ctx<rendering::systems::ShadowMapping>();
+		shadows.castShadow.insert(std::make_pair(transformedMesh.mesh, RESSOURCE_SHADOW_LVL));
+		shadows.shaders.insert(std::make_pair(transformedMesh.mesh, instancedShadowShader));
+
+		auto& picking = registry.ctx<rendering::systems::Picking>();
+		picking.shaders.insert(std::make_pair(transformedMesh.mesh, instancedPickingShader));
+
+		return transformedMeshes.insert(std::make_pair(meshData, transformedMesh)).first->second;
 	}
 
 	rendering::model::Mesh* Chunk::generateWaterMesh()
@@ -340,6 +554,32 @@ namespace game::world
 		return allCells;
 	}
 
+	glm::vec2 Chunk::getFaceCenterPosition(DirectedEdge* edge)
+	{
+		auto found = faceCenterPositions.find(edge);
+		if (found != faceCenterPositions.end())
+			return found->second;
+
+		Face face = edge->calculateFace();
+
+		bool allCellsRelaxed = true;
+		glm::vec2 faceCenterPos = glm::vec2(0.0f, 0.0f);
+		for (Node* node : face.getNodes())
+		{
+			Cell* cell = (Cell*)node->getAdditionalData();
+			faceCenterPos += cell->getRelaxedPosition();
+			allCellsRelaxed &= cell->isRelaxed();
+		}
+		faceCenterPos /= (float)face.getNumNodes();
+
+		// The position of an unrelaxed cell may still change, so the center must not be cached yet.
+		if (allCellsRelaxed)
+			for (DirectedEdge* faceEdge : face.getEdges())
+				faceCenterPositions.insert(std::make_pair(faceEdge, faceCenterPos));
+
+		return faceCenterPos;
+	}
+
 	Chunk::~Chunk()
 	{
 		if (topologyMesh != nullptr)
@@ -348,8 +588,11 @@ namespace game::world
 		if (landscapeMesh != nullptr)
 			delete landscapeMesh;
 
-		if (cellContentMesh != nullptr)
-			delete cellContentMesh;
+		for (auto& meshDataAndMesh : deformedMeshes)
+			delete meshDataAndMesh.second.mesh;
+
+		for (auto& meshDataAndMesh : transformedMeshes)
+			delete meshDataAndMesh.second.mesh;
 
 		for (auto& cell : cells)
 			delete cell.second;
@@ -1062,10 +1305,11 @@ namespace game::world
 		if (content != nullptr)
 		{
 			if (content->hasMeshData())
-				chunk->enqueueUpdate();
+				chunk->enqueueUpdate(this);
 
 			content->removedFromCell(this);
 			content->cells.erase(this);
+			chunk->setHighlightStatus(this, CellHighlightStatus::NO_HIGHLIGHTING);
 
 			if (content->cells.empty())
 				delete content;
@@ -1083,7 +1327,7 @@ namespace game::world
 				content->enqueuedToAddToCell(this);
 
 			if (content->hasMeshData())
-				chunk->enqueueUpdate();
+				chunk->enqueueUpdate(this);
 		}
 	}
 
@@ -1270,55 +1514,52 @@ namespace game::world
 	{
 		auto& found = cells.find(cell);
 		if (found != cells.end())
-		{
-			found->second.highlightStatus = highlightStatus;
-			cell->getChunk()->enqueueUpdate();
-		}
+			cell->getChunk()->setHighlightStatus(cell, highlightStatus);
 	}
 
 	bool CellContent::hasMeshData()
 	{
 		for (auto& cell : cells)
-			if (cell.second.meshData != nullptr)
+			if (cell.second.instancedMeshData != nullptr || cell.second.hasDeformedMeshInstances)
 				return true;
 
 		return false;
 	}
 
-	void CellContent::setMeshData(Cell* cell, std::shared_ptr<rendering::model::MeshData> meshData)
+	void CellContent::setTransform(Cell* cell, const rendering::components::MatrixTransform& transform)
 	{
 		auto& found = cells.find(cell);
 		if (found != cells.end())
 		{
-			found->second.meshData = meshData;
+			found->second.transform = transform;
 
-			cell->getChunk()->enqueueUpdate();
+			cell->getChunk()->enqueueUpdate(cell);
 		}
 	}
 
-	void CellContent::setTransform(Cell* cell, const rendering::components::MatrixTransform& transform)
-	{
+	void CellContent::setInstancedMeshDataAndTransform(
+		Cell* cell,
+		std::shared_ptr<rendering::model::MeshData> instancedMeshData,
+		const rendering::components::MatrixTransform& transform
+	) {
 		auto& found = cells.find(cell);
 		if (found != cells.end())
 		{
+			found->second.instancedMeshData = instancedMeshData;
 			found->second.transform = transform;
 
-			cell->getChunk()->enqueueUpdate();
+			cell->getChunk()->enqueueUpdate(cell);
 		}
 	}
 
-	void CellContent::setMeshDataAndTransform(
-		Cell* cell,
-		std::shared_ptr<rendering::model::MeshData> meshData,
-		const rendering::components::MatrixTransform& transform
-	) {
+	void CellContent::setHasDeformedMeshInstances(Cell* cell, bool hasDeformedMeshInstances)
+	{
 		auto& found = cells.find(cell);
 		if (found != cells.end())
 		{
-			found->second.meshData = meshData;
-			found->second.transform = transform;
+			found->second.hasDeformedMeshInstances = hasDeformedMeshInstances;
 
-			cell->getChunk()->enqueueUpdate();
+			cell->getChunk()->enqueueUpdate(cell);
 		}
 	}
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <functional>
 #include <limits>
 #include <queue>
@@ -18,9 +19,11 @@
 #include "../../rendering/components/MeshRenderer.hpp"
 #include "../../rendering/components/Transform.hpp"
 #include "../../rendering/systems/RenderingSystem.hpp"
+#include "../../rendering/model/BufferTexture.hpp"
 #include "../../rendering/model/Material.hpp"
 #include "../../rendering/model/Mesh.hpp"
 #include "../../rendering/model/MeshPart.hpp"
+#include "CellContentRegistry.hpp"
 #include "Constants.hpp"
 #include "PlanarGraph.hpp"
 #include "HeightGenerator.hpp"
@@ -32,6 +35,11 @@ namespace game::world
 	enum class CellType;
 	class CellContent;
 
+	enum class CellHighlightStatus : uint8_t
+	{
+		NO_HIGHLIGHTING, PLANNED_FOR_CONSTRUCTION, PLANNED_FOR_DESTRUCTION
+	};
+
 	class Chunk
 	{
 	public:
@@ -42,7 +50,13 @@ namespace game::world
 			HeightGenerator& _heightGenerator,
 			entt::registry& _registry,
 			rendering::shading::Shader* _terrainShader,
-			rendering::shading::Shader* _waterShader
+			rendering::shading::Shader* _waterShader,
+			rendering::shading::Shader* _buildingShader,
+			rendering::shading::Shader* _buildingShadowShader,
+			rendering::shading::Shader* _buildingPickingShader,
+			rendering::shading::Shader* _instancedShader,
+			rendering::shading::Shader* _instancedShadowShader,
+			rendering::shading::Shader* _instancedPickingShader
 		) : Chunk(
 			worldSeed,
 			_column,
@@ -51,6 +65,12 @@ namespace game::world
 			_registry,
 			_terrainShader,
 			_waterShader,
+			_buildingShader,
+			_buildingShadowShader,
+			_buildingPickingShader,
+			_instancedShader,
+			_instancedShadowShader,
+			_instancedPickingShader,
 			CHUNK_SIZE,
 			CELL_SIZE
 		) {};
@@ -98,13 +118,26 @@ namespace game::world
 
 		const std::unordered_set<Cell*> getCellsAndCellsAlongChunkBorder();
 
+		// Returns the center position of the face to the left of the given edge (i.e. the face which is calculated when
+		// starting at the edge). The positions are cached once all cells of the face are relaxed.
+		glm::vec2 getFaceCenterPosition(DirectedEdge* edge);
+
 		rendering::model::Mesh* getTopologyMesh();
 
 		rendering::model::Mesh* getLandscapeMesh();
 
-		rendering::model::Mesh* getCellContentMesh()
+		// Inserts the meshes rendering the building pieces of this chunk into the given set.
+		void collectDeformedMeshes(std::unordered_set<rendering::model::Mesh*>& meshes)
 		{
-			return cellContentMesh;
+			for (auto& meshDataAndMesh : deformedMeshes)
+				meshes.insert(meshDataAndMesh.second.mesh);
+		}
+
+		// Inserts the meshes rendering the trees, rocks and other transformed instances of this chunk into the given set.
+		void collectTransformedMeshes(std::unordered_set<rendering::model::Mesh*>& meshes)
+		{
+			for (auto& meshDataAndMesh : transformedMeshes)
+				meshes.insert(meshDataAndMesh.second.mesh);
 		}
 
 		HeightGenerator& getHeightGenerator()
@@ -117,7 +150,11 @@ namespace game::world
 			return registry;
 		}
 
-		void enqueueUpdate();
+		// Enqueues an update of the chunk after the content of the given cell has changed.
+		void enqueueUpdate(Cell* cell);
+
+		// The highlight status of each cell is looked up by the shaders, so changing it doesn't need any mesh updates.
+		void setHighlightStatus(Cell* cell, CellHighlightStatus highlightStatus);
 
 	private:
 		size_t chunkSeed;
@@ -130,10 +167,10 @@ namespace game::world
 		std::unordered_map<uint16_t, Cell*> cells;
 		std::vector<Cell*> cellsAlongChunkBorder;
 		std::array<glm::vec2, 6> cornerPositions;
+		std::unordered_map<DirectedEdge*, glm::vec2> faceCenterPositions;
 
 		rendering::model::Mesh* topologyMesh;
 		rendering::model::Mesh* landscapeMesh;
-		rendering::model::Mesh* cellContentMesh;
 
 		HeightGenerator& heightGenerator;
 
@@ -142,12 +179,60 @@ namespace game::world
 		entt::entity topologyEntity{ entt::null };
 		entt::entity landscapeEntity{ entt::null };
 		entt::entity waterEntity{ entt::null };
-		entt::entity cellContentEntity{ entt::null };
+
+		// The meshes (and the entities rendering them) of all deformed mesh instances within the chunk. The instances of
+		// each cell occupy a range of the instances of their mesh, so that the instances of a single cell can be updated
+		// without uploading the other instances. Freed ranges are filled with degenerate instances (which don't cover any
+		// pixels) until they are reused.
+		struct DeformedMesh
+		{
+			rendering::model::Mesh* mesh;
+			entt::entity entity;
+			std::vector<DeformedMeshInstance> instances;
+			util::RangeAllocator allocator;
+			size_t amountOfUsedInstances{ 0 };
+		};
+
+		struct DeformedMeshRange
+		{
+			DeformedMesh* deformedMesh;
+			size_t offset;
+			size_t size;
+		};
+
+		std::unordered_map<std::shared_ptr<rendering::model::MeshData>, DeformedMesh> deformedMeshes;
+		std::unordered_map<Cell*, std::vector<DeformedMeshRange>> deformedMeshRanges;
+
+		// The meshes (and the entities rendering them) of all transformed mesh instances within the chunk. Each cell with
+		// such an instance occupies one slot of the instances of its mesh, so that the instance of a single cell can be
+		// updated without uploading the other instances.
+		struct TransformedMesh
+		{
+			rendering::model::Mesh* mesh;
+			entt::entity entity;
+			std::shared_ptr<rendering::bounding_geometry::AABB> meshDataBoundingGeometry;
+			std::vector<TransformedMeshInstance> instances;
+			std::vector<Cell*> cellPerSlot;
+		};
+
+		std::unordered_map<std::shared_ptr<rendering::model::MeshData>, TransformedMesh> transformedMeshes;
+		std::unordered_map<Cell*, std::pair<TransformedMesh*, size_t>> transformedMeshSlots;
+
+		std::unordered_set<Cell*> cellsWithChangedContent;
+
+		std::array<CellHighlightStatus, CELL_IDS_PER_CHUNK> cellHighlightStatuses{};
+		std::shared_ptr<rendering::model::BufferTexture> cellHighlightStatusTexture{ nullptr };
 
 		std::shared_ptr<rendering::bounding_geometry::AABB> cullingGeometry;
 
 		rendering::shading::Shader* terrainShader;
 		rendering::shading::Shader* waterShader;
+		rendering::shading::Shader* buildingShader;
+		rendering::shading::Shader* buildingShadowShader;
+		rendering::shading::Shader* buildingPickingShader;
+		rendering::shading::Shader* instancedShader;
+		rendering::shading::Shader* instancedShadowShader;
+		rendering::shading::Shader* instancedPickingShader;
 
 		const int chunkSize;
 		const float cellSize;
@@ -175,6 +260,12 @@ namespace game::world
 			entt::registry& _registry,
 			rendering::shading::Shader* _terrainShader,
 			rendering::shading::Shader* _waterShader,
+			rendering::shading::Shader* _buildingShader,
+			rendering::shading::Shader* _buildingShadowShader,
+			rendering::shading::Shader* _buildingPickingShader,
+			rendering::shading::Shader* _instancedShader,
+			rendering::shading::Shader* _instancedShadowShader,
+			rendering::shading::Shader* _instancedPickingShader,
 			int _chunkSize,
 			float _cellSize
 		);
@@ -187,6 +278,16 @@ namespace game::world
 
 		void update();
 
+		void updateDeformedMeshInstances(Cell* cell);
+
+		void freeDeformedMeshRange(const DeformedMeshRange& range);
+
+		DeformedMesh& getDeformedMesh(const std::shared_ptr<rendering::model::MeshData>& meshData);
+
+		void updateTransformedMeshInstance(Cell* cell);
+
+		TransformedMesh& getTransformedMesh(const std::shared_ptr<rendering::model::MeshData>& meshData);
+
 		class Generator
 		{
 		public:
@@ -304,7 +405,7 @@ namespace game::world
 		{
 			static_assert(std::is_base_of<IBuilding, T>::value, "Template parameter T must be a subclass of IBuilding!");
 
-			if (content != nullptr && dynamic_cast<T*>(content))
+			if (content != nullptr && content->is<T>())
 			{
 				content->enqueuedToAddToCell(this);
 			}
@@ -313,7 +414,7 @@ namespace game::world
 				std::unordered_set<T*> buildingsToConnectTo;
 				for (auto cell : getNeighbors())
 				{
-					T* content = dynamic_cast<T*>(cell->content);
+					T* content = contentCast<T>(cell->content);
 					if (cell->height == height && content)
 						buildingsToConnectTo.insert(content);
 				}
@@ -346,6 +447,7 @@ namespace game::world
 							Inventory& inventory = chunk->getRegistry().get<Inventory>(building->entity);
 							buildingToReuseInventory.addItems(inventory);
 						}
+					buildingToReuse->inventoryUpdated();
 
 					for (auto& cellAndHeight : cellsToPlaceBuildingOn)
 					{
@@ -366,7 +468,7 @@ namespace game::world
 		{
 			static_assert(std::is_base_of<IBuilding, T>::value, "Template parameter T must be a subclass of IBuilding!");
 
-			bool canBePlaced = content != nullptr && dynamic_cast<T*>(content);
+			bool canBePlaced = content != nullptr && content->is<T>();
 			if (canBePlaced)
 				content->addedToCell(this);
 
@@ -458,23 +560,53 @@ namespace game::world
 		GRASS, STONE, SNOW, SAND
 	};
 
-	enum class CellHighlightStatus
+	// An instance of a mesh (e.g. a building piece) which is deformed in the vertex shader: The x and z coordinates of the
+	// mesh (within [0, 1]) are interpolated bilinearly between the four corners and the y coordinate (within [0, 1]) is
+	// scaled to the range between the two heights. The layout matches the instance data expected by the building shaders.
+	struct DeformedMeshInstance
 	{
-		NO_HIGHLIGHTING, PLANNED_FOR_CONSTRUCTION, PLANNED_FOR_DESTRUCTION
+		glm::vec2 frontLeft;
+		glm::vec2 frontRight;
+		glm::vec2 backLeft;
+		glm::vec2 backRight;
+		float lowerHeight;
+		float upperHeight;
+		uint32_t cellId;
+		uint32_t highlightStatus; // Of the piece itself (e.g. a planned floor), shown in addition to the cell's status.
 	};
 
+	static_assert(sizeof(DeformedMeshInstance) == 3 * sizeof(glm::vec4), "Deformed mesh instances must fill three texels!");
+
+	// An instance of a mesh (e.g. a tree) which is transformed in the vertex shader. The layout matches the instance data
+	// expected by the instanced shaders.
+	struct TransformedMeshInstance
+	{
+		glm::mat4 transform;
+		uint32_t cellId;
+		uint32_t padding[3];
+	};
+
+	static_assert(sizeof(TransformedMeshInstance) == 5 * sizeof(glm::vec4), "Transformed mesh instances must fill five texels!");
+
 	struct CellContentCellData
 	{
-		std::shared_ptr<rendering::model::MeshData> meshData{ nullptr };
+		// This mesh is rendered as an instance transformed by the transform of the cell.
+		std::shared_ptr<rendering::model::MeshData> instancedMeshData{ nullptr };
+		// The deformed mesh instances themselves aren't kept once they were uploaded. They are only recreated by the content
+		// (see CellContent::createDeformedMeshInstances) when the cell is updated by its chunk.
+		bool hasDeformedMeshInstances{ false };
 		rendering::components::MatrixTransform transform{ glm::mat4(1.0f) };
-		CellHighlightStatus highlightStatus{ CellHighlightStatus::NO_HIGHLIGHTING };
 	};
 
 	class CellContent
 	{
 	public:
-		CellContent(bool _multiCellPlaceable, const std::string& _typeName, const std::string& _description)
-			: multiCellPlaceable(_multiCellPlaceable), typeName(_typeName), description(_description) {}
+		CellContent(
+			bool _multiCellPlaceable,
+			CellContentTypeId _contentTypeId,
+			const std::string& _typeName,
+			const std::string& _description
+		) : multiCellPlaceable(_multiCellPlaceable), contentTypeId(_contentTypeId), typeName(_typeName), description(_description) {}
 
 		virtual ~CellContent();
 
@@ -506,6 +638,18 @@ namespace game::world
 			return entity;
 		}
 
+		CellContentTypeId getContentTypeId()
+		{
+			return contentTypeId;
+		}
+
+		// Checks whether this cell content is exactly of type T (i.e. not of a subclass of T) by comparing the type tags.
+		template <class T>
+		bool is()
+		{
+			return contentTypeId == cellContentTypeId<T>;
+		}
+
 		const std::string& getTypeName()
 		{
 			return typeName;
@@ -518,6 +662,13 @@ namespace game::world
 
 		Inventory getResourcesObtainedByRemoval(Cell* cell);
 
+		// Appends the deformed mesh instances of the given cell. Only called for cells marked as having deformed mesh
+		// instances, so contents must override this if they mark any of their cells.
+		virtual void createDeformedMeshInstances(
+			Cell* cell,
+			std::vector<std::pair<std::shared_ptr<rendering::model::MeshData>, DeformedMeshInstance>>& instances
+		) {}
+
 		std::string getInventoryContentsString();
 
 	protected:
@@ -543,19 +694,21 @@ namespace game::world
 
 		virtual const Inventory _getResourcesObtainedByRemoval(Cell* cell) = 0;
 
-		void setMeshData(Cell* cell, std::shared_ptr<rendering::model::MeshData> meshData);
-
 		void setTransform(Cell* cell, const rendering::components::MatrixTransform& transform);
 
-		void setMeshDataAndTransform(
+		void setInstancedMeshDataAndTransform(
 			Cell* cell,
-			std::shared_ptr<rendering::model::MeshData> meshData,
+			std::shared_ptr<rendering::model::MeshData> instancedMeshData,
 			const rendering::components::MatrixTransform& transform
 		);
 
+		// Marks whether the given cell has deformed mesh instances and lets the chunk recreate them.
+		void setHasDeformedMeshInstances(Cell* cell, bool hasDeformedMeshInstances);
+
 	private:
 		std::unordered_map<Cell*, CellContentCellData> cells;
 		const bool multiCellPlaceable;
+		const CellContentTypeId contentTypeId;
 		const std::string& typeName;
 		const std::string& description;
 
@@ -568,6 +721,17 @@ namespace game::world
 		friend class World;
 	};
 
+	// Replacement for dynamic_cast<T*>(content) which only compares the content's type tag. Returns nullptr if the given
+	// content is null or not exactly of type T.
+	template <class T>
+	T* contentCast(CellContent* content)
+	{
+		if (content != nullptr && content->is<T>())
+			return static_cast<T*>(content);
+		else
+			return nullptr;
+	}
+
 	struct CellContentComponent
 	{
 		CellContent* cellContent;
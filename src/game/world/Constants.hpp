@@ -5,6 +5,7 @@ namespace game::world
 	// Constants related to the size of the world (size of chunks and individual cells).
 	constexpr int CHUNK_SIZE = 5;
 	constexpr float CELL_SIZE = 6.0f;
+	constexpr size_t CELL_IDS_PER_CHUNK = 1 << 10; // The cell ID is stored in the lower 10 bits of the complete cell ID.
 
 	// Constants related to the cluster relaxation.
 	constexpr int CLUSTER_RELAXATION_ITERATIONS = 16;
@@ -40,6 +41,12 @@ namespace game::world
 	constexpr float DRONE_WOBBLE_HEIGHT = 0.5f;
 	constexpr float DRONE_WOBBLE_SPEED = 2.0f;
 	constexpr float DRONE_ROTOR_ROTATION_SPEED = 25.0f;
+	constexpr size_t DRONE_TASK_QUEUE_CAPACITY = 16;
+	constexpr int DRONE_FLIGHT_LANES = 4;
+	constexpr float DRONE_FLIGHT_LANE_SPACING = 4.0f;
+	constexpr float DRONE_LANE_CHANGE_DURATION = 2.0f;
+	constexpr float DRONE_SEPARATION_RADIUS = 6.0f;
+	constexpr float DRONE_SEPARATION_STRENGTH = 3.0f;
 
 	// Constants related to the resource processing system.
 	constexpr float RESOURCE_MANAGEMENT_RESUPPLY_CONSUMER_UNDER = 10.0f;
@@ -47,6 +54,27 @@ namespace game::world
 	constexpr float RESOURCE_MANAGEMENT_DEFAULT_TRANSPORT_CAPACITY = 5.0f;
 	constexpr float RESOURCE_MANAGEMENT_CANDIDATE_PLANNING_DISTANCE_WEIGHT = 0.01f;
 	constexpr float RESOURCE_MANAGEMENT_CANDIDATE_PLANNING_ITEMS_WEIGHT = 1.0f;
+	constexpr float RESOURCE_MANAGEMENT_DRONE_CARRY_CAPACITY = 15.0f;
+	constexpr size_t RESOURCE_MANAGEMENT_ROUTE_MAX_CANDIDATES = 8;
+	constexpr size_t RESOURCE_MANAGEMENT_TRANSPORT_MAX_ATTEMPTS = 4;
+	constexpr float WAREHOUSE_REGION_SIZE = 64.0f;
+	constexpr float CONSTRUCTION_BACKLOG_REGION_SIZE = 64.0f;
+	constexpr size_t CONSTRUCTION_BACKLOG_MAX_ATTEMPTS = 4;
+
+	// Constants related to the simulation level of detail. Buildings further away from the simulation focus than the LOD
+	// distance process several production steps at once.
+	constexpr float SIMULATION_LOD_DISTANCE = 250.0f;
+	constexpr unsigned int SIMULATION_LOD_COARSE_STEPS = 8;
+	constexpr float SIMULATION_LOD_REFOCUS_DISTANCE = 50.0f;
+
+	// Constants related to the population simulation.
+	constexpr unsigned int CITIZENS_PER_RESIDENCE_FLOOR = 10;
+	constexpr unsigned int JOBS_PER_WORKPLACE_FLOOR = 5;
+	constexpr float CITIZEN_FOOD_PER_MEAL = 0.01f;
+	constexpr float CITIZEN_HUNGER_RATE = 1.0f / 600.0f;
+	constexpr float CITIZEN_STARVING_HUNGER = 0.75f;
+	constexpr size_t POPULATION_UPDATE_STAGGER = 16;
+	constexpr size_t POPULATION_UPDATE_BATCH_SIZE = 4096;
 
 	// Constants related to the mesh generation of chunks.
 	constexpr bool ADD_TOPOLOGY_MESH = false;
@@ -5,33 +5,101 @@ namespace game::world
 	static auto* droneBoundingSpace = new rendering::bounding_geometry::Sphere::ObjectSpace();
 	static auto droneBoundingGeometry = std::make_shared<rendering::bounding_geometry::Sphere>(droneBoundingSpace);
 	static rendering::model::MeshData droneMeshData = rendering::model::MeshData("drone");
-	static rendering::model::Mesh* droneMesh = nullptr;
 
 	static auto* rotorBoundingSpace = new rendering::bounding_geometry::Sphere::ObjectSpace();
 	static auto rotorBoundingGeometry = std::make_shared<rendering::bounding_geometry::Sphere>(rotorBoundingSpace);
 	static rendering::model::MeshData rotorMeshData = rendering::model::MeshData("rotor");
-	static rendering::model::Mesh* rotorMesh = nullptr;
 
 	static auto* crateBoundingSpace = new rendering::bounding_geometry::Sphere::ObjectSpace();
 	static auto crateBoundingGeometry = std::make_shared<rendering::bounding_geometry::Sphere>(crateBoundingSpace);
 	static rendering::model::MeshData crateMeshData = rendering::model::MeshData("crate");
-	static rendering::model::Mesh* crateMesh = nullptr;
 
-	std::default_random_engine randomEngine;
-	std::uniform_real_distribution<float> wobbleDistribution(0.5f, 1.0f);
+	// Each world has its own random engine, so that worlds simulated concurrently don't share any state.
+	struct DroneRandomEngine
+	{
+		std::default_random_engine engine;
+	};
+
+	// Each world has its own drone meshes, which are created by the world's first drone. The mesh data loaded above is only
+	// read, so that worlds can create their meshes concurrently.
+	struct DroneMeshes
+	{
+		rendering::model::Mesh* droneMesh = nullptr;
+		rendering::model::Mesh* rotorMesh = nullptr;
+		rendering::model::Mesh* crateMesh = nullptr;
+
+		DroneMeshes() = default;
+
+		// The meshes are owned by this object, so it must neither be copied nor moved.
+		DroneMeshes(const DroneMeshes&) = delete;
+		DroneMeshes& operator=(const DroneMeshes&) = delete;
+
+		~DroneMeshes()
+		{
+			delete droneMesh;
+			delete rotorMesh;
+			delete crateMesh;
+		}
+	};
+
+	double DroneLeg::getArrivalTime() const
+	{
+		if (speed <= 0.0f)
+			return departureTime;
+
+		return departureTime + glm::distance(start, end) / speed;
+	}
+
+	glm::vec2 DroneLeg::getPosition(double time) const
+	{
+		double arrivalTime = getArrivalTime();
+		if (time >= arrivalTime)
+			return end;
+		else if (time <= departureTime)
+			return start;
+
+		float progress = (float)((time - departureTime) / (arrivalTime - departureTime));
+		return glm::mix(start, end, progress);
+	}
+
+	float DroneLeg::getYaw() const
+	{
+		glm::vec2 direction = end - start;
+		return atan2(direction.x, direction.y);
+	}
+
+	void Drone::depart(const DroneLeg& newLeg)
+	{
+		previousHeightAboveGround = getHeightAboveGround(newLeg.departureTime);
+		leg = newLeg;
+
+		if (leg.start != leg.end)
+		{
+			float heading = (leg.getYaw() + glm::pi<float>()) / glm::two_pi<float>();
+			int lane = std::min((int) (heading * DRONE_FLIGHT_LANES), DRONE_FLIGHT_LANES - 1);
+			heightAboveGround = DRONE_FLIGHT_HEIGHT + lane * DRONE_FLIGHT_LANE_SPACING;
+		}
+	}
+
+	float Drone::getHeightAboveGround(double time) const
+	{
+		float progress = (float) ((time - leg.departureTime) / DRONE_LANE_CHANGE_DURATION);
+		return glm::mix(previousHeightAboveGround, heightAboveGround, glm::clamp(progress, 0.0f, 1.0f));
+	}
 
 	void Drone::inventoryUpdated(entt::registry& registry, entt::entity& entity, Inventory& inventory)
 	{
-		if (inventory.items.empty())
+		if (inventory.empty())
 			registry.remove_if_exists<rendering::components::MeshRenderer>(crateEntity);
 		else
-			registry.emplace_or_replace<rendering::components::MeshRenderer>(crateEntity, crateMesh);
+			registry.emplace_or_replace<rendering::components::MeshRenderer>(crateEntity, registry.ctx<DroneMeshes>().crateMesh);
 	}
 
 	rendering::model::Mesh* setUpMesh(
-		rendering::model::MeshData& meshData,
+		const rendering::model::MeshData& sharedMeshData,
 		std::shared_ptr<rendering::bounding_geometry::BoundingGeometry> boundingGeometry
 	) {
+		rendering::model::MeshData meshData = sharedMeshData;
 		auto cellIds = std::make_shared<rendering::model::VertexAttribute<glm::uvec2>>(
 			2,
 			rendering::model::VertexAttributeType::INTEGER,
@@ -39,11 +107,28 @@ namespace game::world
 			);
 		for (size_t i = 0; i < meshData.vertices.size(); i++)
 			cellIds->attributeData.push_back(glm::uvec2(std::numeric_limits<uint32_t>::max() - 1, 0));
-		meshData.additionalVertexAttributes.insert(std::make_pair(CELL_ID_ATTRIBUTE_LOCATION, cellIds));
+		meshData.additionalVertexAttributes[CELL_ID_ATTRIBUTE_LOCATION] = cellIds;
 
 		return new rendering::model::Mesh(meshData, boundingGeometry);
 	}
 
+	DroneMeshes& getDroneMeshes(entt::registry& registry)
+	{
+		DroneMeshes* existingMeshes = registry.try_ctx<DroneMeshes>();
+		if (existingMeshes != nullptr)
+			return *existingMeshes;
+
+		DroneMeshes& meshes = registry.set<DroneMeshes>();
+		meshes.droneMesh = setUpMesh(droneMeshData, droneBoundingGeometry);
+		meshes.rotorMesh = setUpMesh(rotorMeshData, rotorBoundingGeometry);
+		meshes.crateMesh = setUpMesh(crateMeshData, crateBoundingGeometry);
+
+		auto& shadows = registry.ctx<rendering::systems::ShadowMapping>();
+		shadows.castShadow.insert(std::make_pair(meshes.droneMesh, 0));
+
+		return meshes;
+	}
+
 	void Drone::spawnNewDrone(entt::registry& registry, const glm::vec3& position)
 	{
 		entt::entity droneEntity = registry.create();
@@ -53,34 +138,30 @@ namespace game::world
 		entt::entity crateEntity = registry.create();
 		entt::entity spotLightEntity = registry.create();
 
-		if (droneMesh == nullptr)
-		{
-			droneMesh = setUpMesh(droneMeshData, droneBoundingGeometry);
-			rotorMesh = setUpMesh(rotorMeshData, rotorBoundingGeometry);
-			crateMesh = setUpMesh(crateMeshData, crateBoundingGeometry);
-
-			auto& shadows = registry.ctx<rendering::systems::ShadowMapping>();
-			shadows.castShadow.insert(std::make_pair(droneMesh, 0));
-		}
+		DroneMeshes& meshes = getDroneMeshes(registry);
 
-		registry.emplace<Drone>(droneEntity, rotor1Entity, rotor2Entity, rotor3Entity, crateEntity, spotLightEntity, wobbleDistribution(randomEngine));
+		auto& randomEngine = registry.ctx_or_set<DroneRandomEngine>().engine;
+		float relativeWobbleSpeed = std::uniform_real_distribution<float>(0.5f, 1.0f)(randomEngine);
+		auto& drone = registry.emplace<Drone>(droneEntity, rotor1Entity, rotor2Entity, rotor3Entity, crateEntity, spotLightEntity, relativeWobbleSpeed);
+		drone.leg.start = glm::vec2(position.x, position.z);
+		drone.leg.end = drone.leg.start;
 		registry.emplace<Inventory>(droneEntity);
-		registry.emplace<rendering::components::MeshRenderer>(droneEntity, droneMesh);
+		registry.emplace<rendering::components::MeshRenderer>(droneEntity, meshes.droneMesh);
 		registry.emplace<rendering::components::CullingGeometry>(droneEntity, droneBoundingGeometry);
 		registry.emplace<rendering::components::EulerComponentwiseTransform>(droneEntity, position, 0, 0, 0, glm::vec3(1.0f));
 		registry.emplace<rendering::components::Relationship>(droneEntity);
 
-		registry.emplace<rendering::components::MeshRenderer>(rotor1Entity, rotorMesh);
+		registry.emplace<rendering::components::MeshRenderer>(rotor1Entity, meshes.rotorMesh);
 		registry.emplace<rendering::components::CullingGeometry>(rotor1Entity, rotorBoundingGeometry);
 		registry.emplace<rendering::components::EulerComponentwiseTransform>(rotor1Entity, glm::vec3(0.0f, 0.72f, -1.8f), 0, 0, 0, glm::vec3(1.0f));
 		registry.emplace<rendering::components::Relationship>(rotor1Entity);
 
-		registry.emplace<rendering::components::MeshRenderer>(rotor2Entity, rotorMesh);
+		registry.emplace<rendering::components::MeshRenderer>(rotor2Entity, meshes.rotorMesh);
 		registry.emplace<rendering::components::CullingGeometry>(rotor2Entity, rotorBoundingGeometry);
 		registry.emplace<rendering::components::EulerComponentwiseTransform>(rotor2Entity, glm::vec3(-1.5f, 0.72f, 1.2f), 0, 0, 0, glm::vec3(1.0f));
 		registry.emplace<rendering::components::Relationship>(rotor2Entity);
 
-		registry.emplace<rendering::components::MeshRenderer>(rotor3Entity, rotorMesh);
+		registry.emplace<rendering::components::MeshRenderer>(rotor3Entity, meshes.rotorMesh);
 		registry.emplace<rendering::components::CullingGeometry>(rotor3Entity, rotorBoundingGeometry);
 		registry.emplace<rendering::components::EulerComponentwiseTransform>(rotor3Entity, glm::vec3(1.5f, 0.72f, 1.2f), 0, 0, 0, glm::vec3(1.0f));
 		registry.emplace<rendering::components::Relationship>(rotor3Entity);
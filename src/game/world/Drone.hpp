@@ -1,20 +1,68 @@
 #pragma once
 
+#include <random>
 #include <vector>
-#include <queue>
 
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
 
 #include "../../rendering/bounding_geometry/Sphere.hpp"
 #include "../../rendering/model/Mesh.hpp"
 #include "../../rendering/systems/TransformHierarchySystem.hpp"
+#include "../../util/RingBuffer.hpp"
 #include "Chunk.hpp"
 #include "Inventory.hpp"
 
 namespace game::world
 {
-	struct DroneTask;
+	class IBuilding;
+
+	enum class DroneTaskType : uint8_t
+	{
+		PICKUP,
+		DELIVERY,
+		CONSTRUCTION,
+		DESTRUCTION
+	};
+
+	// A task which is pursued by a drone. Tasks are stored by value in the drone's task queue, so that scheduling tasks
+	// doesn't cause any heap allocations. Which of the fields are used depends on the task's type.
+	struct DroneTask
+	{
+		DroneTaskType type{ DroneTaskType::PICKUP };
+		Cell* destination{ nullptr };
+
+		// Pickups and deliveries: The type and amount of the item to transport and the entity for which the transport was
+		// registered as a planned inventory change (or entt::null if the planned change was already executed or cancelled).
+		IItem* itemType{ nullptr };
+		float amount{ 0.0f };
+		entt::entity plannedChangeEntity{ entt::null };
+		bool exact{ false };
+		bool checkHarvestables{ false };
+
+		// Constructions: The type of the building to construct.
+		IBuilding* buildingType{ nullptr };
+	};
+
+	using DroneTaskQueue = util::RingBuffer<DroneTask, DRONE_TASK_QUEUE_CAPACITY>;
+
+	// A straight flight of a drone from one position to another. The drone's position is never integrated, but evaluated
+	// from the time at which the drone departed whenever it is needed, so that drones which are not visible don't need to
+	// be moved at all.
+	struct DroneLeg
+	{
+		glm::vec2 start{ 0.0f };
+		glm::vec2 end{ 0.0f };
+		double departureTime{ 0.0 };
+		float speed{ 0.0f };
+
+		double getArrivalTime() const;
+
+		glm::vec2 getPosition(double time) const;
+
+		float getYaw() const;
+	};
 
 	struct Drone
 	{
@@ -25,33 +73,27 @@ namespace game::world
 		entt::entity spotLightEntity{ entt::null };
 
 		float relativeWobbleSpeed{ 1.0f };
+		float spotLightIntensity{ 0.0f };
+
+		// Drones fly in altitude lanes depending on their heading, so that drones flying in different directions pass
+		// above each other. After departing, the drone climbs or descends from its previous height to the height of its
+		// lane.
 		float heightAboveGround{ DRONE_FLIGHT_HEIGHT };
+		float previousHeightAboveGround{ DRONE_FLIGHT_HEIGHT };
+
+		DroneTaskQueue tasks;
+		DroneLeg leg;
 
-		std::queue<DroneTask*> tasks;
+		// Whether the drone was inside the camera frustum during the last animation update.
+		bool visible{ false };
+
+		// Starts the given leg and switches to the altitude lane matching the leg's heading.
+		void depart(const DroneLeg& newLeg);
+
+		float getHeightAboveGround(double time) const;
 
 		void inventoryUpdated(entt::registry& registry, entt::entity& entity, Inventory& inventory);
 
 		static void spawnNewDrone(entt::registry& registry, const glm::vec3& position);
 	};
-
-	struct DroneTask
-	{
-		world::Cell* destination;
-
-		DroneTask(world::Cell* _destination) : destination(_destination) {}
-
-		virtual bool checkAndUpdateDestination(
-			entt::registry& registry,
-			entt::entity& entity,
-			Drone& drone,
-			Inventory& inventory
-		) = 0;
-
-		virtual bool destinationReached(
-			entt::registry& registry,
-			entt::entity& entity,
-			Drone& drone,
-			Inventory& inventory
-		) = 0;
-	};
 }
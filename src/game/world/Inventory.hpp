@@ -1,237 +1,146 @@
 #pragma once
 
+#include <array>
 #include <functional>
+#include <initializer_list>
 #include <sstream>
 #include <string>
-#include <typeindex>
 
 #include <entt/entt.hpp>
 
+#include "ItemRegistry.hpp"
+
 namespace game::world
 {
-	struct IHarvestable;
-	struct IStores;
-	struct IProduces;
-	struct IConsumes;
-
+	// Describes a type of item. There is exactly one instance per item type (see Item<T>::getTypeRepresentative()), so item
+	// types can be compared by their address or their index in the item registry.
 	struct IItem
 	{
-		float amount;
+		const size_t index;
 		const std::string& typeName;
 
-		IItem(float _amount, const std::string& _typeName) : amount(_amount), typeName(_typeName) {}
-
-		virtual std::shared_ptr<IItem> clone() = 0;
-
-		virtual std::shared_ptr<IItem> clone(float clonedAmount) = 0;
-
-		virtual std::shared_ptr<IItem> split(float amountToSplit) = 0;
-
-		virtual IHarvestable* getHarvestable() = 0;
-
-		virtual IStores* getStores() = 0;
-
-		virtual IProduces* getProduces() = 0;
-
-		virtual IConsumes* getConsumes() = 0;
+		IItem(size_t _index, const std::string& _typeName) : index(_index), typeName(_typeName) {}
+	};
 
-		virtual size_t getTypeHashCode() const = 0;
+	// Returns the item type with the given index in the item registry.
+	IItem* getItemType(size_t index);
 
-		virtual std::type_index getTypeIndex() const = 0;
+	struct ItemAmount
+	{
+		size_t itemTypeIndex;
+		float amount;
 	};
 
-	struct IItemHash
+	// Stores the amount of each item type in a dense array indexed by the item type's index in the item registry. Adding and
+	// removing items is therefore plain arithmetic without any allocations.
+	struct Inventory
 	{
-		size_t operator() (const IItem* item) const
-		{
-			return item->getTypeHashCode();
-		}
+		std::array<float, AMOUNT_OF_ITEM_TYPES> amounts{};
 
-		size_t operator() (const std::shared_ptr<IItem> item) const
-		{
-			return item->getTypeHashCode();
-		}
-	};
+		Inventory() {}
 
-	struct IItemComparator
-	{
-		bool operator() (const IItem* a, const IItem* b) const
+		Inventory(std::initializer_list<ItemAmount> items)
 		{
-			return a->getTypeIndex() == b->getTypeIndex();
+			for (const ItemAmount& item : items)
+				amounts[item.itemTypeIndex] += item.amount;
 		}
 
-		bool operator() (const std::shared_ptr<IItem> a, const std::shared_ptr<IItem> b) const
+		bool empty() const
 		{
-			return a->getTypeIndex() == b->getTypeIndex();
-		}
-	};
-
-	struct Inventory
-	{
-		std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator> items;
-
-		Inventory() {}
+			for (float amount : amounts)
+				if (amount != 0.0f)
+					return false;
 
-		Inventory(const std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>& _items) : items(_items) {}
+			return true;
+		}
 
 		void addItems(const Inventory& source)
 		{
-			for (std::shared_ptr<IItem> item : source.items)
-				addItem(item->clone());
+			for (size_t i = 0; i < AMOUNT_OF_ITEM_TYPES; i++)
+				amounts[i] += source.amounts[i];
 		}
 
-		void addItem(std::shared_ptr<IItem> item)
+		void addItem(const IItem* itemType, float amount)
 		{
-			if (item == nullptr)
-				return;
-
-			auto& found = items.find(item);
-			if (found == items.end())
-				items.insert(item);
-			else
-				(*found)->amount += item->amount;
+			amounts[itemType->index] += amount;
 		}
 
 		template <class T>
 		void addItemTyped(float amount)
 		{
-			addItem(std::make_shared<T>(amount));
+			amounts[itemTypeIndex<T>] += amount;
 		}
 
-		float getStoredAmount(std::shared_ptr<IItem> itemType)
+		float getStoredAmount(const IItem* itemType) const
 		{
-			auto& found = items.find(itemType);
-			if (found == items.end())
-				return 0.0f;
-			else
-				return (*found)->amount;
-		}
-
-		std::shared_ptr<IItem> getItem(std::shared_ptr<IItem> itemType)
-		{
-			auto& found = items.find(itemType);
-			if (found == items.end())
-				return nullptr;
-			else
-				return *found;
+			return amounts[itemType->index];
 		}
 
 		template <class T>
-		std::shared_ptr<T> getItemTyped()
+		float getStoredAmountTyped() const
 		{
-			static_assert(std::is_base_of<Item<T>, T>::value, "Template parameter T must be a subclass of Item!");
-
-			return std::dynamic_pointer_cast<T>(getItem(T::getTypeRepresentative()));
+			return amounts[itemTypeIndex<T>];
 		}
 
-		std::shared_ptr<IItem> removeItem(std::shared_ptr<IItem> itemType, float maxAmount)
+		// Removes up to maxAmount items of the given type (or all items of that type if maxAmount is negative) and returns
+		// the amount which was actually removed.
+		float removeItem(const IItem* itemType, float maxAmount)
 		{
-			auto& found = items.find(itemType);
-			if (found == items.end())
-			{
-				return nullptr;
-			}
-			else
-			{
-				std::shared_ptr<IItem> result = (*found)->split(maxAmount);
-
-				if ((*found)->amount == 0.0f)
-					items.erase(found);
-
-				return result;
-			}
+			return removeItemAt(itemType->index, maxAmount);
 		}
 
 		template <class T>
-		std::shared_ptr<T> removeItemTyped(float maxAmount)
+		float removeItemTyped(float maxAmount)
 		{
-			static_assert(std::is_base_of<Item<T>, T>::value, "Template parameter T must be a subclass of Item!");
-
-			return std::dynamic_pointer_cast<T>(removeItem(T::getTypeRepresentative(), maxAmount));
+			return removeItemAt(itemTypeIndex<T>, maxAmount);
 		}
 
 		void split(unsigned int amount)
 		{
 			float multiplier = 1.0f / ((float) amount);
 
-			for (std::shared_ptr<IItem> item : items)
-				item->amount *= multiplier;
+			for (float& storedAmount : amounts)
+				storedAmount *= multiplier;
 		}
 
-		std::string getStoredItemsString()
+		// Calls func(IItem* itemType, float amount) for each item type which is stored in this inventory.
+		template <class Func>
+		void forEachItem(Func func) const
 		{
-			std::stringstream storedItemsString;
+			for (size_t i = 0; i < AMOUNT_OF_ITEM_TYPES; i++)
+				if (amounts[i] != 0.0f)
+					func(getItemType(i), amounts[i]);
+		}
 
-			auto iterator = items.begin();
-			while (iterator != items.end()) {
-				const std::shared_ptr<IItem>& item = *iterator;
+		std::string getStoredItemsString() const
+		{
+			std::stringstream storedItemsString;
 
-				storedItemsString << item->typeName << ": " << item->amount;
-				if ((++iterator) != items.end())
+			bool first = true;
+			forEachItem([&storedItemsString, &first](IItem* itemType, float amount) {
+				if (!first)
 					storedItemsString << std::endl;
-			}
+				first = false;
+
+				storedItemsString << itemType->typeName << ": " << amount;
+			});
 
 			return storedItemsString.str();
 		}
-	};
-
-	struct IHarvestable
-	{
-		virtual std::shared_ptr<IItem> getItem() = 0;
-
-		virtual IHarvestable* getFromEntity(entt::registry& registry, entt::entity& entity) = 0;
-
-		virtual entt::entity getAny(entt::registry& registry) = 0;
-
-		virtual void iterateAllEntities(entt::registry& registry, std::function<void(entt::entity&, IHarvestable*)>& func) = 0;
-
-		virtual void addToEntity(entt::registry& registry, entt::entity& entity) = 0;
-
-		virtual void removeFromEntity(entt::registry& registry, entt::entity& entity) = 0;
-	};
-
-	struct IStores
-	{
-		virtual std::shared_ptr<IItem> getItem() = 0;
-
-		virtual IStores* getFromEntity(entt::registry& registry, entt::entity& entity) = 0;
-
-		virtual entt::entity getAny(entt::registry& registry) = 0;
 
-		virtual void iterateAllEntities(entt::registry& registry, std::function<void(entt::entity&, IStores*)>& func) = 0;
-
-		virtual void addToEntity(entt::registry& registry, entt::entity& entity) = 0;
-
-		virtual void removeFromEntity(entt::registry& registry, entt::entity& entity) = 0;
-	};
-
-	struct IProduces
-	{
-		virtual std::shared_ptr<IItem> getItem() = 0;
-
-		virtual IProduces* getFromEntity(entt::registry& registry, entt::entity& entity) = 0;
-
-		virtual entt::entity getAny(entt::registry& registry) = 0;
-
-		virtual void iterateAllEntities(entt::registry& registry, std::function<void(entt::entity&, IProduces*)>& func) = 0;
-
-		virtual void addToEntity(entt::registry& registry, entt::entity& entity) = 0;
-
-		virtual void removeFromEntity(entt::registry& registry, entt::entity& entity) = 0;
-	};
-
-	struct IConsumes
-	{
-		virtual std::shared_ptr<IItem> getItem() = 0;
-
-		virtual IConsumes* getFromEntity(entt::registry& registry, entt::entity& entity) = 0;
-
-		virtual entt::entity getAny(entt::registry& registry) = 0;
-
-		virtual void iterateAllEntities(entt::registry& registry, std::function<void(entt::entity&, IConsumes*)>& func) = 0;
+	private:
+		float removeItemAt(size_t index, float maxAmount)
+		{
+			float& storedAmount = amounts[index];
 
-		virtual void addToEntity(entt::registry& registry, entt::entity& entity) = 0;
+			float removedAmount;
+			if (maxAmount < 0.0f || maxAmount > storedAmount)
+				removedAmount = storedAmount;
+			else
+				removedAmount = maxAmount;
 
-		virtual void removeFromEntity(entt::registry& registry, entt::entity& entity) = 0;
+			storedAmount -= removedAmount;
+			return removedAmount;
+		}
 	};
 }
@@ -7,4 +7,17 @@ namespace game::world
 	const std::string Ores::TYPE_NAME = "Ores";
 	const std::string Biomass::TYPE_NAME = "Biomass";
 	const std::string Food::TYPE_NAME = "Food";
+
+	template <class... Types>
+	std::array<IItem*, AMOUNT_OF_ITEM_TYPES> createItemTypeTable(ItemTypeList<Types...>)
+	{
+		return { Types::getTypeRepresentative()... };
+	}
+
+	static const std::array<IItem*, AMOUNT_OF_ITEM_TYPES> itemTypeTable = createItemTypeTable(RegisteredItemTypes());
+
+	IItem* getItemType(size_t index)
+	{
+		return itemTypeTable[index];
+	}
 }
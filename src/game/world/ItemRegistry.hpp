@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace game::world
+{
+	struct Wood;
+	struct Stone;
+	struct Ores;
+	struct Biomass;
+	struct Food;
+
+	template <class... Types>
+	struct ItemTypeList
+	{
+		static constexpr size_t size = sizeof...(Types);
+	};
+
+	// All item types known to the game. Each item type is identified by its position in this list, so that inventories can
+	// store the amount of each item type in a plain array. New item types must be added here.
+	using RegisteredItemTypes = ItemTypeList<Wood, Stone, Ores, Biomass, Food>;
+
+	constexpr size_t AMOUNT_OF_ITEM_TYPES = RegisteredItemTypes::size;
+
+	template <class T, class List>
+	struct ItemTypeIndex;
+
+	template <class T, class... Types>
+	struct ItemTypeIndex<T, ItemTypeList<T, Types...>> : std::integral_constant<size_t, 0> {};
+
+	template <class T, class First, class... Types>
+	struct ItemTypeIndex<T, ItemTypeList<First, Types...>>
+		: std::integral_constant<size_t, 1 + ItemTypeIndex<T, ItemTypeList<Types...>>::value> {};
+
+	template <class T>
+	constexpr size_t itemTypeIndex = ItemTypeIndex<T, RegisteredItemTypes>::value;
+}
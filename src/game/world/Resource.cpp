@@ -2,8 +2,16 @@
 
 namespace game::world
 {
-	std::default_random_engine generator;
-	std::uniform_real_distribution<float> randomFloat(0.0f, 1.0f);
+	// Each world has its own random engine, so that worlds simulated concurrently don't share any state.
+	struct ResourceRandomEngine
+	{
+		std::default_random_engine engine;
+	};
+
+	static float randomFloat(entt::registry& registry)
+	{
+		return std::uniform_real_distribution<float>(0.0f, 1.0f)(registry.ctx_or_set<ResourceRandomEngine>().engine);
+	}
 
 	static const Inventory emptyInventory = Inventory();
 
@@ -23,7 +31,7 @@ namespace game::world
 
 	void Resource::_addedToCell(Cell* cell)
 	{
-		setMeshDataAndTransform(cell, meshData, rendering::components::EulerComponentwiseTransform(
+		setInstancedMeshDataAndTransform(cell, meshData, rendering::components::EulerComponentwiseTransform(
 			cell->getRelaxedPositionAndHeight(),
 			0.0f, 0.0f, 0.0f,
 			glm::vec3(1.0f)
@@ -46,7 +54,7 @@ namespace game::world
 	{
 		// If the resource's inventory is empty, the resource was fully harvested, so it needs to be removed from the world.
 		Inventory& inventory = getRegistry()->get<Inventory>(getEntity());
-		if (inventory.items.empty())
+		if (inventory.empty())
 		{
 			// Copying the cells is needed because the removal will (a) modify the cells map which would cause an iteration over
 			// a changed map and (b) eventually delete this object which could cause null pointer exceptions and illegal memory
@@ -65,19 +73,20 @@ namespace game::world
 		return emptyInventory;
 	}
 
-	Tree::Tree() : Resource(treeTypeName, treeDescription, randomFloat(generator) > 0.5f ? treeMeshData : treeMeshData2) {}
+	Tree::Tree() : Resource(cellContentTypeId<Tree>, treeTypeName, treeDescription, treeMeshData) {}
 
 	void Tree::__addedToCell(Cell* cell)
 	{
-		setTransform(cell, rendering::components::EulerComponentwiseTransform(
-			cell->getRelaxedPositionAndHeight(),
-			2.0f * M_PI * randomFloat(generator), 0.0f, 0.0f,
-			glm::vec3(0.8f + 0.3f * randomFloat(generator))
-		).toTransformationMatrix());
-
 		entt::registry* registry = getRegistry();
 		entt::entity& entity = getEntity();
 
+		// The tree's mesh is chosen once it is added to a world, as the random engine belongs to the world.
+		setInstancedMeshDataAndTransform(cell, randomFloat(*registry) > 0.5f ? treeMeshData : treeMeshData2, rendering::components::EulerComponentwiseTransform(
+			cell->getRelaxedPositionAndHeight(),
+			2.0f * M_PI * randomFloat(*registry), 0.0f, 0.0f,
+			glm::vec3(0.8f + 0.3f * randomFloat(*registry))
+		).toTransformationMatrix());
+
 		registry->get<Inventory>(entity).addItemTyped<Wood>(1.0f);
 		registry->emplace<Harvestable<Wood>>(entity);
 	}
@@ -93,20 +102,20 @@ namespace game::world
 	}
 
 
-	Rock::Rock() : Resource(rockTypeName, rockDescription, stoneMeshData) {}
+	Rock::Rock() : Resource(cellContentTypeId<Rock>, rockTypeName, rockDescription, stoneMeshData) {}
 
 	void Rock::__addedToCell(Cell* cell)
 	{
+		entt::registry* registry = getRegistry();
+		entt::entity& entity = getEntity();
+
 		auto transform = rendering::components::EulerComponentwiseTransform(
 			cell->getRelaxedPositionAndHeight(),
-			2.0f * M_PI * randomFloat(generator), 0.0f, 0.0f,
-			glm::vec3(0.75f + 0.25f * randomFloat(generator))
+			2.0f * M_PI * randomFloat(*registry), 0.0f, 0.0f,
+			glm::vec3(0.75f + 0.25f * randomFloat(*registry))
 		).toTransformationMatrix();
 		setTransform(cell, transform);
 
-		entt::registry* registry = getRegistry();
-		entt::entity& entity = getEntity();
-
 		registry->get<Inventory>(entity).addItemTyped<Stone>(1.0f);
 		registry->emplace<Harvestable<Stone>>(entity);
 
@@ -15,10 +15,11 @@ namespace game::world
 	{
 	public:
 		Resource(
+			CellContentTypeId _contentTypeId,
 			const std::string& _typeName,
 			const std::string& _description,
 			std::shared_ptr<rendering::model::MeshData> _meshData
-		) : CellContent(false, _typeName, _description), meshData(_meshData) {}
+		) : CellContent(false, _contentTypeId, _typeName, _description), meshData(_meshData) {}
 
 		void inventoryUpdated();
 
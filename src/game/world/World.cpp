@@ -6,13 +6,26 @@ namespace game::world
 		size_t _worldSeed,
 		entt::registry& _registry,
 		rendering::shading::Shader* _terrainShader,
-		rendering::shading::Shader* _waterShader
+		rendering::shading::Shader* _waterShader,
+		rendering::shading::Shader* _buildingShader,
+		rendering::shading::Shader* _buildingShadowShader,
+		rendering::shading::Shader* _buildingPickingShader,
+		rendering::shading::Shader* _instancedShader,
+		rendering::shading::Shader* _instancedShadowShader,
+		rendering::shading::Shader* _instancedPickingShader
 	) :
 		worldSeed(_worldSeed),
+		chunksAddedToWorld(0),
 		heightGenerator(HeightGenerator(worldSeed)),
 		registry(_registry),
 		terrainShader(_terrainShader),
 		waterShader(_waterShader),
+		buildingShader(_buildingShader),
+		buildingShadowShader(_buildingShadowShader),
+		buildingPickingShader(_buildingPickingShader),
+		instancedShader(_instancedShader),
+		instancedShadowShader(_instancedShadowShader),
+		instancedPickingShader(_instancedPickingShader),
 		chunksToGenerate(moodycamel::ReaderWriterQueue<std::pair<int32_t, int32_t>>(100)),
 		generatedChunks(moodycamel::ReaderWriterQueue<Chunk*>(100))
 	{
@@ -27,6 +40,12 @@ namespace game::world
 			registry, 
 			terrainShader, 
 			waterShader, 
+			buildingShader,
+			buildingShadowShader,
+			buildingPickingShader,
+			instancedShader,
+			instancedShadowShader,
+			instancedPickingShader,
 			chunkSize, 
 			cellSize
 		);
@@ -66,7 +85,7 @@ namespace game::world
 		}
 
 		// Create a new chunk and generate its topology (i.e. cells and their neighborhood).
-		chunk = new Chunk(worldSeed, column, row, heightGenerator, registry, terrainShader, waterShader);
+		chunk = new Chunk(worldSeed, column, row, heightGenerator, registry, terrainShader, waterShader, buildingShader, buildingShadowShader, buildingPickingShader, instancedShader, instancedShadowShader, instancedPickingShader);
 		allChunks.insert(std::make_pair(std::make_pair(column, row), chunk));
 
 		std::array<Chunk*, 6> neighbors{
@@ -229,6 +248,7 @@ namespace game::world
 		if (generatedChunks.try_dequeue(nextChunkToAdd))
 		{
 			nextChunkToAdd->addedToWorld();
+			chunksAddedToWorld++;
 
 			if (GENERATE_RESOURCES)
 			{
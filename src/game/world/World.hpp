@@ -39,7 +39,13 @@ namespace game::world
 			size_t _worldSeed,
 			entt::registry& _registry,
 			rendering::shading::Shader* _terrainShader,
-			rendering::shading::Shader* _waterShader
+			rendering::shading::Shader* _waterShader,
+			rendering::shading::Shader* _buildingShader,
+			rendering::shading::Shader* _buildingShadowShader,
+			rendering::shading::Shader* _buildingPickingShader,
+			rendering::shading::Shader* _instancedShader,
+			rendering::shading::Shader* _instancedShadowShader,
+			rendering::shading::Shader* _instancedPickingShader
 		);
 
 		~World();
@@ -67,6 +73,11 @@ namespace game::world
 			return heightGenerator;
 		}
 
+		size_t getAmountOfChunksAddedToWorld()
+		{
+			return chunksAddedToWorld;
+		}
+
 		void update();
 
 	private:
@@ -77,6 +88,7 @@ namespace game::world
 		std::unordered_map<std::uint16_t, std::vector<Chunk*>> relaxedChunksById;
 		std::unordered_map<ChunkClusterIdentifier, ChunkCluster*> chunkClusters;
 		PlanarGraph graph;
+		size_t chunksAddedToWorld;
 
 		HeightGenerator heightGenerator;
 
@@ -84,6 +96,12 @@ namespace game::world
 
 		rendering::shading::Shader* terrainShader;
 		rendering::shading::Shader* waterShader;
+		rendering::shading::Shader* buildingShader;
+		rendering::shading::Shader* buildingShadowShader;
+		rendering::shading::Shader* buildingPickingShader;
+		rendering::shading::Shader* instancedShader;
+		rendering::shading::Shader* instancedShadowShader;
+		rendering::shading::Shader* instancedPickingShader;
 
 		moodycamel::ReaderWriterQueue<std::pair<int32_t, int32_t>> chunksToGenerate;
 		moodycamel::ReaderWriterQueue<Chunk*> generatedChunks;
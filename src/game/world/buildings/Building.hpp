@@ -1,13 +1,13 @@
 #pragma once
 
 #include <functional>
-#include <stdexcept>
 #include <vector>
 
 #include <entt/entt.hpp>
 
 #include "../../../rendering/components/Transform.hpp"
 #include "../../../rendering/model/Mesh.hpp"
+#include "../../systems/PopulationSystem.hpp"
 #include "../../systems/ResourceProcessingSystem.hpp"
 #include "../BuildingPieceSet.hpp"
 #include "../Chunk.hpp"
@@ -30,7 +30,7 @@ namespace game::world
 				return false;
 
 			CellContent* existingContent = cell->getContent();
-			if (existingContent != nullptr && dynamic_cast<BuildingType*>(existingContent) == nullptr)
+			if (existingContent != nullptr && !existingContent->is<BuildingType>())
 				return false;
 
 			return _canBePlacedOnCell(cell);
@@ -52,6 +52,20 @@ namespace game::world
 
 		virtual const Inventory& getResourcesObtainedByRemoval() = 0;
 
+		// The pieces of a cell are recreated from the heights of the cells whenever its chunk updates the cell, so that they
+		// don't need to be kept in memory.
+		void createDeformedMeshInstances(
+			Cell* cell,
+			std::vector<std::pair<std::shared_ptr<rendering::model::MeshData>, DeformedMeshInstance>>& instances
+		) {
+			auto height = heightPerCell.find(cell);
+			if (height == heightPerCell.end())
+				return;
+
+			for (auto& face : cell->getFaces())
+				addMeshPieces(instances, cell, face, height->second.getMaxHeight());
+		}
+
 	protected:
 		Building(
 			const std::string& _typeName,
@@ -59,7 +73,12 @@ namespace game::world
 			std::shared_ptr<BuildingPieceSet> _buildingPieceSet,
 			IBuilding* original,
 			std::unordered_set<Cell*> cellsToCopy
-		) : IBuilding(_typeName, _description, _buildingPieceSet, original, cellsToCopy) {}
+		) : IBuilding(cellContentTypeId<BuildingType>, _typeName, _description, _buildingPieceSet, original, cellsToCopy)
+		{
+			// A copy doesn't have any mesh data yet, so all of its cells must be built once.
+			for (auto& cellAndHeight : heightPerCell)
+				dirtyCells.insert(cellAndHeight.first);
+		}
 
 		CellContent* createNewCellContentOfSameType(std::unordered_set<Cell*> cellsToCopy)
 		{
@@ -76,17 +95,24 @@ namespace game::world
 			else
 				heightPerCell.insert(std::make_pair(cell, BuildingHeight{ 1, 0 }));
 
+			markDirty(cell);
 			enqueueUpdate();
 		}
 
 		void _addedToCell(Cell* cell)
 		{
+			// Coarse simulation steps are processed at their end using the occupied space at that time. The steps which are
+			// already due must be processed before the occupied space changes, so that the change doesn't apply to them
+			// retroactively. Catching up also schedules the building again.
+			game::systems::catchUpResourceProcessing(*getRegistry(), getEntity());
+
 			auto& height = heightPerCell.find(cell);
 			if (height != heightPerCell.end())
 				height->second.actualHeight += 1;
 			else
 				heightPerCell.insert(std::make_pair(cell, BuildingHeight{ 1, 1 }));
 
+			markDirty(cell);
 			enqueueUpdate();
 
 			__addedToCell(cell);
@@ -97,12 +123,17 @@ namespace game::world
 		void _enqueuedToRemoveFromCell(Cell* cell)
 		{
 			heightPerCell[cell].plannedHeight = 0;
+			markDirty(cell);
 			enqueueUpdate();
 		}
 
 		void _removedFromCell(Cell* cell)
 		{
+			// See _addedToCell.
+			game::systems::catchUpResourceProcessing(*getRegistry(), getEntity());
+
 			heightPerCell.erase(cell);
+			markDirty(cell);
 
 			if (!heightPerCell.empty())
 				enqueueUpdate();
@@ -114,36 +145,31 @@ namespace game::world
 
 		void update()
 		{
-			rebuildMeshData();
+			// The pieces themselves are only created once the chunks of the cells upload them.
+			for (Cell* cell : dirtyCells)
+				setHasDeformedMeshInstances(cell, heightPerCell.find(cell) != heightPerCell.end());
+			dirtyCells.clear();
 		}
 
 	private:
-		void rebuildMeshData()
-		{
-			std::unordered_map<Cell*, std::vector<std::shared_ptr<rendering::model::MeshData>>> meshPieces;
-			for (auto& cellAndHeight : heightPerCell)
-				for (auto& face : cellAndHeight.first->getFaces())
-					for (unsigned int floor = 0; floor < cellAndHeight.second.getMaxHeight(); floor++)
-						addMeshPieces(meshPieces, cellAndHeight.first, face, floor);
-
-			for (auto& cellAndPieces : meshPieces)
-			{
-				std::vector<std::pair<std::shared_ptr<rendering::model::MeshData>, std::vector<rendering::model::MeshDataInstance>>> instances;
-				for (auto piece : cellAndPieces.second)
-				{
-					auto instance = rendering::model::MeshDataInstance(glm::mat4(1.0f));
-					instances.push_back(std::make_pair(piece, std::vector<rendering::model::MeshDataInstance> { instance }));
-				}
+		// The cells whose pieces must be recreated by their chunks after the next update.
+		std::unordered_set<Cell*> dirtyCells;
 
-				setMeshData(cellAndPieces.first, std::make_shared<rendering::model::MeshData>(instances));
-			}
+		// The pieces of a cell only depend on which corners of the cubes around the cell are occupied, i.e. on the heights
+		// of the cells sharing a face with it. Changing the height of a cell therefore only affects these cells.
+		void markDirty(Cell* cell)
+		{
+			dirtyCells.insert(cell);
+			for (auto& face : cell->getFaces())
+				for (auto& node : face->getNodes())
+					dirtyCells.insert((Cell*)node->getAdditionalData());
 		}
 
 		void addMeshPieces(
-			std::unordered_map<Cell*, std::vector<std::shared_ptr<rendering::model::MeshData>>>& meshPieces,
+			std::vector<std::pair<std::shared_ptr<rendering::model::MeshData>, DeformedMeshInstance>>& meshPieces,
 			Cell* cell,
 			Face* face,
-			unsigned int floor
+			unsigned int amountOfFloors
 		) {
 			// Determine the indices of the four cells within the face.
 			unsigned int cellIndex = 0;
@@ -159,196 +185,98 @@ namespace game::world
 			Cell* diagonalNeighborCell = (Cell*)(nodes[diagonalNeighborIndex]->getAdditionalData());
 			Cell* clockwiseNeighborCell = (Cell*)(nodes[clockwiseNeighborIndex]->getAdditionalData());
 
-			// Determine which corners of the current cube are occupied.
-			bool occupiedCellUp = occupies(cell, floor + 1);
-			bool occupiedCounterClockwiseDown = occupies(counterClockwiseNeighborCell, floor);
-			bool occupiedCounterClockwiseUp = occupies(counterClockwiseNeighborCell, floor + 1);
-			bool occupiedDiagonalDown = occupies(diagonalNeighborCell, floor);
-			bool occupiedDiagonalUp = occupies(diagonalNeighborCell, floor + 1);
-			bool occupiedClockwiseDown = occupies(clockwiseNeighborCell, floor);
-			bool occupiedClockwiseUp = occupies(clockwiseNeighborCell, floor + 1);
-
-			// Determine whether we must place a straight edge piece, an outer corner piece, an inner corner piece or a
-			// no edge piece.
-			bool straightEdgeDown = occupiedClockwiseDown != occupiedCounterClockwiseDown;
-			bool straightEdgeUp = occupiedClockwiseUp != occupiedCounterClockwiseUp;
-			bool outerCornerDown = !occupiedClockwiseDown && !occupiedCounterClockwiseDown;
-			bool outerCornerUp = !occupiedClockwiseUp && !occupiedCounterClockwiseUp;
-			bool innerCornerDown = occupiedClockwiseDown && occupiedCounterClockwiseDown && !occupiedDiagonalDown;
-			bool innerCornerUp = occupiedClockwiseUp && occupiedCounterClockwiseUp && !occupiedDiagonalUp;
-			bool noEdgeDown = occupiedClockwiseDown && occupiedCounterClockwiseDown && occupiedDiagonalDown;
-			bool noEdgeUp = occupiedClockwiseUp && occupiedCounterClockwiseUp && occupiedDiagonalUp;
-
-			// Calculate the height at which the pieces must be located at.
-			float lowerHeight = cell->getHeight() + floor * BUILDING_FLOOR_HEIGHT;
-			float centerHeight = cell->getHeight() + (floor + 0.5f) * BUILDING_FLOOR_HEIGHT;
-			float upperHeight = cell->getHeight() + (floor + 1) * BUILDING_FLOOR_HEIGHT;
-
-			// Calculate the position of the face's center.
-			glm::vec2 faceCenterPos = (cell->getRelaxedPosition() + counterClockwiseNeighborCell->getRelaxedPosition()
-				+ diagonalNeighborCell->getRelaxedPosition() + clockwiseNeighborCell->getRelaxedPosition()) / 4.0f;
-
-			Face cellNeighborFace = face->getEdges()[cellIndex]->getOtherDirection()->calculateFace();
-			glm::vec2 cellNeighborFaceCenterPos =
-				(((Cell*)cellNeighborFace.getNodes()[0]->getAdditionalData())->getRelaxedPosition()
-				+ ((Cell*)cellNeighborFace.getNodes()[1]->getAdditionalData())->getRelaxedPosition()
-				+ ((Cell*)cellNeighborFace.getNodes()[2]->getAdditionalData())->getRelaxedPosition()
-				+ ((Cell*)cellNeighborFace.getNodes()[3]->getAdditionalData())->getRelaxedPosition()) / 4.0f;
-
-			Face clockwiseNeighborFace = face->getEdges()[clockwiseNeighborIndex]->getOtherDirection()->calculateFace();
-			glm::vec2 clockwiseNeighborFaceCenterPos =
-				(((Cell*)clockwiseNeighborFace.getNodes()[0]->getAdditionalData())->getRelaxedPosition()
-					+ ((Cell*)clockwiseNeighborFace.getNodes()[1]->getAdditionalData())->getRelaxedPosition()
-					+ ((Cell*)clockwiseNeighborFace.getNodes()[2]->getAdditionalData())->getRelaxedPosition()
-					+ ((Cell*)clockwiseNeighborFace.getNodes()[3]->getAdditionalData())->getRelaxedPosition()) / 4.0f;
-
-			// Determine the positions of the piece's four corners (from a top-down view).
-			glm::vec2 frontLeft, frontRight, backLeft, backRight;
-			bool onRightHalf = straightEdgeDown && occupiedClockwiseDown || !straightEdgeDown && !noEdgeDown
-				|| noEdgeDown && (straightEdgeUp && occupiedClockwiseUp || !straightEdgeUp);
-			if (onRightHalf)
-			{
-				frontLeft = faceCenterPos;
-				frontRight = (faceCenterPos + cellNeighborFaceCenterPos) / 2.0f;
-				backLeft = (faceCenterPos + clockwiseNeighborFaceCenterPos) / 2.0f;
-				backRight = cell->getRelaxedPosition();
-			}
-			else
+			// Determine which corners of the cube of each floor are occupied and look up the pieces to place. The lower and
+			// upper pieces of all floors form a column of slots (from bottom to top).
+			std::vector<const BuildingPieceSelection*> selections(amountOfFloors);
+			std::vector<BuildingPieceSlot> slots(2 * amountOfFloors);
+			for (unsigned int floor = 0; floor < amountOfFloors; floor++)
 			{
-				frontLeft = (faceCenterPos + clockwiseNeighborFaceCenterPos) / 2.0f;
-				frontRight = faceCenterPos;
-				backLeft = cell->getRelaxedPosition();
-				backRight = (faceCenterPos + cellNeighborFaceCenterPos) / 2.0f;
+				uint8_t occupancy = 0;
+				if (occupies(cell, floor + 1))
+					occupancy |= OCCUPIED_CELL_UP;
+				if (occupies(counterClockwiseNeighborCell, floor))
+					occupancy |= OCCUPIED_COUNTER_CLOCKWISE_DOWN;
+				if (occupies(counterClockwiseNeighborCell, floor + 1))
+					occupancy |= OCCUPIED_COUNTER_CLOCKWISE_UP;
+				if (occupies(diagonalNeighborCell, floor))
+					occupancy |= OCCUPIED_DIAGONAL_DOWN;
+				if (occupies(diagonalNeighborCell, floor + 1))
+					occupancy |= OCCUPIED_DIAGONAL_UP;
+				if (occupies(clockwiseNeighborCell, floor))
+					occupancy |= OCCUPIED_CLOCKWISE_DOWN;
+				if (occupies(clockwiseNeighborCell, floor + 1))
+					occupancy |= OCCUPIED_CLOCKWISE_UP;
+
+				selections[floor] = &BUILDING_PIECE_SELECTION_TABLE[occupancy];
+				slots[2 * floor] = selections[floor]->lowerPiece;
+				slots[2 * floor + 1] = selections[floor]->upperPiece;
 			}
 
-			// Determine which pieces need to be placed. Beware: Ugly tree of nested if-else-branches ahead!
-			std::shared_ptr<BuildingPiece> lowerPiece;
-			std::shared_ptr<BuildingPiece> upperPiece;
-			if (straightEdgeDown)
-			{
-				// TODO: As of now, only the first building piece of each type will be used. Once we have buildings which
-				// have multiple pieces per type, some algorithm (for example Wave Function Collapse) should be used to
-				// determine the actual piece to place.
-				lowerPiece = buildingPieceSet->getStraightEdgeWallPieces()[0];
-				if (occupiedCellUp)
-				{
-					if (outerCornerUp && onRightHalf)
-					{
-						upperPiece = buildingPieceSet->getStraightEdgeWallRoofRightPieces()[0];
-					}
-					else if (outerCornerUp && !onRightHalf)
-					{
-						upperPiece = buildingPieceSet->getStraightEdgeWallRoofLeftPieces()[0];
-					}
-					else
-					{
-						upperPiece = buildingPieceSet->getStraightEdgeWallPieces()[0];
-					}
-				}
-				else
-				{
-					upperPiece = buildingPieceSet->getStraightEdgeWallRoofOuterCornerPieces()[0];
-				}
-			}
-			else if (outerCornerDown)
-			{
-				lowerPiece = buildingPieceSet->getOuterCornerWallPieces()[0];
-				if (occupiedCellUp)
-				{
-					upperPiece = buildingPieceSet->getOuterCornerWallPieces()[0];
-				}
-				else
-				{
-					upperPiece = buildingPieceSet->getOuterCornerWallRoofOuterCornerPieces()[0];
-				}
-			}
-			else if (innerCornerDown)
+			// Choose the actual pieces using Wave Function Collapse. The variant must only depend on the cell and the face
+			// (which is identified by its counter clockwise neighbor), so that rebuilding a column doesn't change its look.
+			size_t variant = (cell->getCompleteId() * 73856093u ^ counterClockwiseNeighborCell->getCompleteId() * 19349663u)
+				% AMOUNT_OF_BUILDING_PIECE_VARIANTS;
+			std::vector<uint8_t> pieceIndices = buildingPieceSet->solveColumn(slots, variant);
+
+			// Get the center positions of the face and of the two neighboring faces sharing an edge with the cell.
+			auto& edges = face->getEdges();
+			Chunk* chunk = cell->getChunk();
+			glm::vec2 faceCenterPos = chunk->getFaceCenterPosition(edges[cellIndex]);
+			glm::vec2 cellNeighborFaceCenterPos = chunk->getFaceCenterPosition(edges[cellIndex]->getOtherDirection());
+			glm::vec2 clockwiseNeighborFaceCenterPos = chunk->getFaceCenterPosition(edges[clockwiseNeighborIndex]->getOtherDirection());
+
+			for (unsigned int floor = 0; floor < amountOfFloors; floor++)
 			{
-				lowerPiece = buildingPieceSet->getInnerCornerWallPieces()[0];
-				if (occupiedCellUp)
+				const BuildingPieceSelection& selection = *selections[floor];
+
+				// Calculate the height at which the pieces must be located at.
+				float lowerHeight = cell->getHeight() + floor * BUILDING_FLOOR_HEIGHT;
+				float centerHeight = cell->getHeight() + (floor + 0.5f) * BUILDING_FLOOR_HEIGHT;
+				float upperHeight = cell->getHeight() + (floor + 1) * BUILDING_FLOOR_HEIGHT;
+
+				// Determine the positions of the piece's four corners (from a top-down view).
+				glm::vec2 frontLeft, frontRight, backLeft, backRight;
+				if (selection.onRightHalf)
 				{
-					if (straightEdgeUp && occupiedCounterClockwiseUp)
-					{
-						upperPiece = buildingPieceSet->getInnerCornerWallRoofRightPieces()[0];
-					}
-					else if (straightEdgeUp && occupiedClockwiseUp)
-					{
-						upperPiece = buildingPieceSet->getInnerCornerWallRoofLeftPieces()[0];
-					}
-					else if (outerCornerUp)
-					{
-						upperPiece = buildingPieceSet->getInnerCornerWallRoofBothPieces()[0];
-					}
-					else
-					{
-						upperPiece = buildingPieceSet->getInnerCornerWallPieces()[0];
-					}
+					frontLeft = faceCenterPos;
+					frontRight = (faceCenterPos + cellNeighborFaceCenterPos) / 2.0f;
+					backLeft = (faceCenterPos + clockwiseNeighborFaceCenterPos) / 2.0f;
+					backRight = cell->getRelaxedPosition();
 				}
 				else
 				{
-					upperPiece = buildingPieceSet->getInnerCornerWallRoofOuterCornerPieces()[0];
+					frontLeft = (faceCenterPos + clockwiseNeighborFaceCenterPos) / 2.0f;
+					frontRight = faceCenterPos;
+					backLeft = cell->getRelaxedPosition();
+					backRight = (faceCenterPos + cellNeighborFaceCenterPos) / 2.0f;
 				}
-			}
-			else if (noEdgeDown)
-			{
-				lowerPiece = nullptr;
-				if (!occupiedCellUp)
+
+				if (selection.lowerPiece != BuildingPieceSlot::NONE)
 				{
-					upperPiece = buildingPieceSet->getNoEdgeRoofPieces()[0];
+					auto& lowerPiece = buildingPieceSet->getPieces(selection.lowerPiece)[pieceIndices[2 * floor]];
+					auto instance = createPieceInstance(
+						frontLeft, frontRight, backLeft, backRight,
+						lowerHeight, centerHeight,
+						heightPerCell[cell], floor
+					);
+					meshPieces.push_back(std::make_pair(lowerPiece->getMeshData(), instance));
 				}
-				else
+
+				if (selection.upperPiece != BuildingPieceSlot::NONE)
 				{
-					if (straightEdgeUp)
-					{
-						upperPiece = buildingPieceSet->getStraightEdgeRoofWallInnerCornerPieces()[0];
-					}
-					else if (outerCornerUp)
-					{
-						upperPiece = buildingPieceSet->getOuterCornerRoofWallInnerCornerPieces()[0];
-					}
-					else if (innerCornerUp)
-					{
-						upperPiece = buildingPieceSet->getInnerCornerRoofWallInnerCornerPieces()[0];
-					}
-					else if (noEdgeUp)
-					{
-						upperPiece = nullptr;
-					}
-					else
-					{
-						throw std::logic_error("Piece is neither an edge nor a corner nor an inner piece! This must be a bug.");
-					}
+					auto& upperPiece = buildingPieceSet->getPieces(selection.upperPiece)[pieceIndices[2 * floor + 1]];
+					auto instance = createPieceInstance(
+						frontLeft, frontRight, backLeft, backRight,
+						centerHeight, upperHeight,
+						heightPerCell[cell], floor
+					);
+					meshPieces.push_back(std::make_pair(upperPiece->getMeshData(), instance));
 				}
-
-			}
-			else
-			{
-				throw std::logic_error("Piece is neither an edge nor a corner nor an inner piece! This must be a bug.");
-			}
-
-			if (lowerPiece != nullptr)
-			{
-				auto data = constructMeshDataForPiece(
-					lowerPiece, frontLeft, frontRight, backLeft, backRight,
-					lowerHeight, centerHeight,
-					heightPerCell[cell], floor
-				);
-				meshPieces[cell].push_back(data);
-			}
-
-			if (upperPiece != nullptr)
-			{
-				auto data = constructMeshDataForPiece(
-					upperPiece, frontLeft, frontRight, backLeft, backRight,
-					centerHeight, upperHeight,
-					heightPerCell[cell], floor
-				);
-				meshPieces[cell].push_back(data);
 			}
 		}
 
-		std::shared_ptr<rendering::model::MeshData> constructMeshDataForPiece(
-			std::shared_ptr<BuildingPiece> piece,
+		// The piece's mesh is deformed to fit between the given corners and heights in the vertex shader.
+		DeformedMeshInstance createPieceInstance(
 			glm::vec2 frontLeft,
 			glm::vec2 frontRight,
 			glm::vec2 backLeft,
@@ -358,55 +286,18 @@ namespace game::world
 			const BuildingHeight& buildingHeight,
 			unsigned int floor
 		) {
-			float deltaHeight = upperHeight - lowerHeight;
-			constexpr float normalEpsilon = 0.1f;
-
-			auto cellIds = std::make_shared<rendering::model::VertexAttribute<glm::uvec2>>(
-				2,
-				rendering::model::VertexAttributeType::INTEGER,
-				GL_UNSIGNED_INT
-			);
-
 			CellHighlightStatus highlightStatus = CellHighlightStatus::NO_HIGHLIGHTING;
 			if (floor >= buildingHeight.actualHeight)
 				highlightStatus = CellHighlightStatus::PLANNED_FOR_CONSTRUCTION;
 			else if (floor >= buildingHeight.plannedHeight)
 				highlightStatus = CellHighlightStatus::PLANNED_FOR_DESTRUCTION;
 
-			auto meshData = std::make_shared<rendering::model::MeshData>(*piece->getMeshData());
-			for (int i = 0; i < meshData->vertices.size(); i++)
-			{
-				// Transform the vertex from object coordinates to world coordinates.
-				glm::vec3& vertex = meshData->vertices[i];
-				glm::vec2 pos = glm::vec2(vertex.x, vertex.z);
-				glm::vec2 transformedPos = interpolateBilinear(pos, frontLeft, frontRight, backLeft, backRight);
-				vertex = glm::vec3(transformedPos.x, vertex.y * deltaHeight + lowerHeight, transformedPos.y);
-
-				// Transform the corresponding normal from object coordinates to world coordinates.
-				glm::vec3& normal = meshData->normals[i];
-				pos += normalEpsilon * glm::vec2(normal.x, normal.z);
-				glm::vec2 normalDir = interpolateBilinear(pos, frontLeft, frontRight, backLeft, backRight) - transformedPos;
-				normal = glm::normalize(glm::vec3(normalDir.x, normalEpsilon * normal.y * deltaHeight, normalDir.y));
-
-				cellIds->attributeData.push_back(glm::uvec2(0, highlightStatus));
-			}
-
-			meshData->additionalVertexAttributes.insert(std::make_pair(CELL_ID_ATTRIBUTE_LOCATION, cellIds));
-
-			return meshData;
-		}
-
-		glm::vec2 interpolateBilinear(
-			const glm::vec2& point,
-			const glm::vec2& frontLeft,
-			const glm::vec2& frontRight,
-			const glm::vec2& backLeft,
-			const glm::vec2& backRight
-		) {
-			return (1 - point.x) * (1 - point.y) * frontLeft
-				+ point.x * (1 - point.y) * frontRight
-				+ (1 - point.x) * point.y * backLeft
-				+ point.x * point.y * backRight;
+			// The cell ID is filled in by the chunk.
+			return DeformedMeshInstance{
+				frontLeft, frontRight, backLeft, backRight,
+				lowerHeight, upperHeight,
+				0, (uint32_t)highlightStatus
+			};
 		}
 
 		bool occupies(Cell* cell, unsigned int floor)
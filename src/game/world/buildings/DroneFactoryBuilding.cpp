@@ -4,8 +4,8 @@ namespace game::world
 {
 	static const std::string buildingTypeName = "Drone Factory";
 	static const std::string buildingDescription = "A factory for producing more drones. Consumes ores for each drone to produce.";
-	static const Inventory constructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Stone>(4.0f), std::make_shared<Ores>(2.0f) });
-	static const Inventory destructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Stone>(2.0f), std::make_shared<Ores>(1.0f) });
+	static const Inventory constructionResources = Inventory({ { itemTypeIndex<Stone>, 4.0f }, { itemTypeIndex<Ores>, 2.0f } });
+	static const Inventory destructionResources = Inventory({ { itemTypeIndex<Stone>, 2.0f }, { itemTypeIndex<Ores>, 1.0f } });
 
 	static std::shared_ptr<BuildingPieceSet> pieceSet = std::make_shared<BuildingPieceSet>(
 		std::vector<std::shared_ptr<StraightEdgeBuildingPiece>>{ std::make_shared<StraightEdgeBuildingPiece>(
@@ -131,47 +131,67 @@ namespace game::world
 	);
 
 	static class DroneFactoryResourceProcessor : public game::systems::IResourceProcessor {
-		void processResources(entt::registry& registry, double deltaTime)
+	public:
+		void processResources(entt::registry& registry, entt::entity entity, double scheduledTime)
 		{
-			double time = glfwGetTime();
+			auto* building = registry.try_get<DroneFactoryBuildingComponent>(entity);
+			if (building == nullptr || building->nextProduction != scheduledTime)
+				return;
 
-			for (auto& entity : registry.view<DroneFactoryBuildingComponent>())
+			Inventory& inventory = registry.get<Inventory>(entity);
+			if (building->amountOfDronesToProduce == 0 || !hasEnoughOres(inventory))
 			{
-				registry.patch<DroneFactoryBuildingComponent>(entity, [&registry, entity, time](auto& building) {
-					if (building.amountOfDronesToProduce > 0)
-					{
-						registry.emplace_or_replace<Consumes<Ores>>(entity);
-
-						Inventory& inventory = registry.get<Inventory>(entity);
-						std::shared_ptr<Ores> ores = inventory.getItemTyped<Ores>();
-						bool hasEnoughOres = ores != nullptr && ores->amount >= 3.0f;
-						if (hasEnoughOres)
-						{
-							float occupiedSpace = building.building->getTotalAmountOfActualOccupiedSpace();
-							float timeForProduction = 30.0f + 30.0f / occupiedSpace;
-
-							if (time - building.lastProduced > timeForProduction)
-							{
-								building.lastProduced = time;
-								building.amountOfDronesToProduce -= 1;
-								inventory.removeItemTyped<Ores>(3.0f);
-
-								glm::vec3 cellPos = building.building->getCells().begin()->first->getRelaxedPositionAndHeight();
-								Drone::spawnNewDrone(registry, cellPos + glm::vec3(0.0f, DRONE_FLIGHT_HEIGHT, 0.0f));
-							}
-						}
-						else
-						{
-							building.lastProduced = time;
-						}
-					}
-					else
-					{
-						building.lastProduced = time;
-						registry.remove_if_exists<Consumes<Ores>>(entity);
-					}
-				});
+				building->nextProduction = -1.0;
+				return;
 			}
+
+			building->lastProduced = scheduledTime;
+			building->amountOfDronesToProduce -= 1;
+			inventory.removeItemTyped<Ores>(3.0f);
+
+			glm::vec3 cellPos = building->building->getCells().begin()->first->getRelaxedPositionAndHeight();
+			Drone::spawnNewDrone(registry, cellPos + glm::vec3(0.0f, DRONE_FLIGHT_HEIGHT, 0.0f));
+
+			schedule(registry, entity);
+		}
+
+		// (Re)schedules the next production. Must be called whenever the occupied space, the inventory or the amount of
+		// drones to produce changes. While there is nothing to produce or not enough ores, the factory isn't scheduled.
+		void schedule(entt::registry& registry, entt::entity entity)
+		{
+			auto& building = registry.get<DroneFactoryBuildingComponent>(entity);
+
+			// Ores are only requested while there are drones to produce.
+			if (building.amountOfDronesToProduce > 0 && !registry.has<Consumes<Ores>>(entity))
+				registry.emplace<Consumes<Ores>>(entity);
+			else if (building.amountOfDronesToProduce == 0)
+				registry.remove_if_exists<Consumes<Ores>>(entity);
+
+			if (building.amountOfDronesToProduce == 0 || !hasEnoughOres(registry.get<Inventory>(entity)))
+			{
+				building.nextProduction = -1.0;
+				return;
+			}
+
+			// The production time only starts to elapse once there are enough ores.
+			if (building.nextProduction < 0.0)
+				building.lastProduced = game::getSimulationTime(registry);
+
+			float occupiedSpace = building.building->getTotalAmountOfActualOccupiedSpace();
+			float timeForProduction = 30.0f + 30.0f / occupiedSpace;
+
+			double nextProduction = building.lastProduced + timeForProduction;
+			if (nextProduction != building.nextProduction)
+			{
+				building.nextProduction = nextProduction;
+				game::systems::scheduleResourceProcessing(registry, this, entity, nextProduction);
+			}
+		}
+
+	private:
+		bool hasEnoughOres(Inventory& inventory)
+		{
+			return inventory.getStoredAmountTyped<Ores>() >= 3.0f;
 		}
 	} resourceProcessor;
 
@@ -187,20 +207,33 @@ namespace game::world
 
 	void DroneFactoryBuilding::__addedToCell(Cell* cell)
 	{
-		game::systems::attachResourceProcessor(&resourceProcessor);
-
 		if (!getRegistry()->has<DroneFactoryBuildingComponent>(getEntity()))
-			getRegistry()->emplace<DroneFactoryBuildingComponent>(getEntity(), this);
+			getRegistry()->emplace<DroneFactoryBuildingComponent>(getEntity(), this, game::getSimulationTime(*getRegistry()));
+
+		resourceProcessor.schedule(*getRegistry(), getEntity());
+
+		game::systems::setJobCapacity(*getRegistry(), getEntity(), JOBS_PER_WORKPLACE_FLOOR * getTotalAmountOfActualOccupiedSpace());
 	}
 
 	void DroneFactoryBuilding::__removedFromCell(Cell* cell)
 	{
-		// Nothing to do here...
+		if (getTotalAmountOfActualOccupiedSpace() > 0)
+			resourceProcessor.schedule(*getRegistry(), getEntity());
+
+		game::systems::setJobCapacity(*getRegistry(), getEntity(), JOBS_PER_WORKPLACE_FLOOR * getTotalAmountOfActualOccupiedSpace());
 	}
 
 	void DroneFactoryBuilding::inventoryUpdated()
 	{
-		// Nothing to do here...
+		// Deliveries of ores may allow the factory to resume its production.
+		if (getRegistry()->valid(getEntity()) && getRegistry()->has<DroneFactoryBuildingComponent>(getEntity()))
+			resourceProcessor.schedule(*getRegistry(), getEntity());
+	}
+
+	void DroneFactoryBuilding::enqueueDroneProduction()
+	{
+		getRegistry()->get<DroneFactoryBuildingComponent>(getEntity()).amountOfDronesToProduce++;
+		resourceProcessor.schedule(*getRegistry(), getEntity());
 	}
 
 	const Inventory& DroneFactoryBuilding::getResourcesRequiredToBuild()
@@ -19,6 +19,8 @@ namespace game::world
 
 		const Inventory& getResourcesObtainedByRemoval();
 
+		void enqueueDroneProduction();
+
 	protected:
 		bool _canBePlacedOnCell(Cell* cell);
 
@@ -29,10 +31,13 @@ namespace game::world
 
 	struct DroneFactoryBuildingComponent
 	{
-		DroneFactoryBuildingComponent(DroneFactoryBuilding* _building) : building(_building), lastProduced(glfwGetTime()), amountOfDronesToProduce(1) {}
+		DroneFactoryBuildingComponent(DroneFactoryBuilding* _building, double time) : building(_building), lastProduced(time), nextProduction(-1.0), amountOfDronesToProduce(1) {}
 
 		DroneFactoryBuilding* building;
 		double lastProduced;
+
+		// The time of the next production, or a negative value while the factory waits for ores or has nothing to produce.
+		double nextProduction;
 		unsigned int amountOfDronesToProduce;
 	};
 }
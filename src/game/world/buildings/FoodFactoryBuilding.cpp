@@ -4,8 +4,8 @@ namespace game::world
 {
 	static const std::string buildingTypeName = "Food Factory";
 	static const std::string buildingDescription = "Consumes biomass to produce food.";
-	static const Inventory constructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Stone>(4.0f), std::make_shared<Ores>(2.0f) });
-	static const Inventory destructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Stone>(2.0f), std::make_shared<Ores>(1.0f) });
+	static const Inventory constructionResources = Inventory({ { itemTypeIndex<Stone>, 4.0f }, { itemTypeIndex<Ores>, 2.0f } });
+	static const Inventory destructionResources = Inventory({ { itemTypeIndex<Stone>, 2.0f }, { itemTypeIndex<Ores>, 1.0f } });
 
 	static std::shared_ptr<BuildingPieceSet> pieceSet = std::make_shared<BuildingPieceSet>(
 		std::vector<std::shared_ptr<StraightEdgeBuildingPiece>>{ std::make_shared<StraightEdgeBuildingPiece>(
@@ -132,42 +132,99 @@ namespace game::world
 
 	struct FoodFactoryBuildingComponent
 	{
-		FoodFactoryBuildingComponent(FoodFactoryBuilding* _building) : building(_building), lastProduced(glfwGetTime()) {}
+		FoodFactoryBuildingComponent(FoodFactoryBuilding* _building, double time)
+			: building(_building), lastProduced(time), nextProduction(-1.0), productionSteps(1) {}
 
 		FoodFactoryBuilding* building;
 		double lastProduced;
+
+		// The time of the next production, or a negative value while the building waits for biomass.
+		double nextProduction;
+		unsigned int productionSteps;
 	};
 
 	static class FoodFactoryResourceProcessor : public game::systems::IResourceProcessor {
-		void processResources(entt::registry& registry, double deltaTime)
+	public:
+		void processResources(entt::registry& registry, entt::entity entity, double scheduledTime)
+		{
+			auto* building = registry.try_get<FoodFactoryBuildingComponent>(entity);
+			if (building == nullptr || building->nextProduction != scheduledTime)
+				return;
+
+			Inventory& inventory = registry.get<Inventory>(entity);
+			if (!hasEnoughBiomass(inventory))
+			{
+				building->nextProduction = -1.0;
+				return;
+			}
+
+			building->lastProduced = scheduledTime;
+			produce(inventory, building->productionSteps);
+
+			schedule(registry, entity);
+		}
+
+		void catchUp(entt::registry& registry, entt::entity entity, double time)
+		{
+			auto* building = registry.try_get<FoodFactoryBuildingComponent>(entity);
+			if (building == nullptr || building->productionSteps == 1 || building->nextProduction < 0.0)
+				return;
+
+			double timeForProduction = getTimeForProduction(*building);
+			unsigned int dueSteps = (unsigned int) ((time - building->lastProduced) / timeForProduction);
+			building->lastProduced += dueSteps * timeForProduction;
+			produce(registry.get<Inventory>(entity), dueSteps);
+
+			schedule(registry, entity);
+		}
+
+		// (Re)schedules the next production. Must be called whenever the occupied space or the inventory of the building
+		// changes. While there is not enough biomass, the building isn't scheduled at all.
+		void schedule(entt::registry& registry, entt::entity entity)
 		{
-			double time = glfwGetTime();
+			auto& building = registry.get<FoodFactoryBuildingComponent>(entity);
+			if (!hasEnoughBiomass(registry.get<Inventory>(entity)))
+			{
+				building.nextProduction = -1.0;
+				return;
+			}
 
-			for (auto& entity : registry.view<FoodFactoryBuildingComponent>())
+			// The production time only starts to elapse once there is enough biomass.
+			if (building.nextProduction < 0.0)
+				building.lastProduced = game::getSimulationTime(registry);
+
+			building.productionSteps = game::systems::getSimulationSteps(registry, entity);
+
+			double nextProduction = building.lastProduced + building.productionSteps * getTimeForProduction(building);
+			if (nextProduction != building.nextProduction)
 			{
-				registry.patch<FoodFactoryBuildingComponent>(entity, [&registry, entity, time](auto& building) {
-					Inventory& inventory = registry.get<Inventory>(entity);
-					std::shared_ptr<Biomass> biomass = inventory.getItemTyped<Biomass>();
-					bool hasEnoughBiomass = biomass != nullptr && biomass->amount >= 1.0f;
-					if (hasEnoughBiomass)
-					{
-						float occupiedSpace = building.building->getTotalAmountOfActualOccupiedSpace();
-						float timeForProduction = 60.0f / occupiedSpace;
-
-						if (time - building.lastProduced > timeForProduction)
-						{
-							building.lastProduced = time;
-							inventory.removeItemTyped<Biomass>(1.0f);
-							inventory.addItemTyped<Food>(1.0f);
-						}
-					}
-					else
-					{
-						building.lastProduced = time;
-					}
-				});
+				building.nextProduction = nextProduction;
+				game::systems::scheduleResourceProcessing(registry, this, entity, nextProduction);
 			}
 		}
+
+	private:
+		bool hasEnoughBiomass(Inventory& inventory)
+		{
+			return inventory.getStoredAmountTyped<Biomass>() >= 1.0f;
+		}
+
+		double getTimeForProduction(FoodFactoryBuildingComponent& building)
+		{
+			float occupiedSpace = building.building->getTotalAmountOfActualOccupiedSpace();
+			return 60.0f / occupiedSpace;
+		}
+
+		// Converts one unit of biomass into one unit of food per step for as long as there is enough biomass.
+		void produce(Inventory& inventory, unsigned int steps)
+		{
+			float amount = std::min((float) steps, std::floor(inventory.getStoredAmountTyped<Biomass>()));
+			if (amount <= 0.0f)
+				return;
+
+			inventory.removeItemTyped<Biomass>(amount);
+			inventory.addItemTyped<Food>(amount);
+		}
 	} resourceProcessor;
 
 	FoodFactoryBuilding::FoodFactoryBuilding(
@@ -182,24 +239,31 @@ namespace game::world
 
 	void FoodFactoryBuilding::__addedToCell(Cell* cell)
 	{
-		game::systems::attachResourceProcessor(&resourceProcessor);
-
 		if (!getRegistry()->has<FoodFactoryBuildingComponent>(getEntity()))
 		{
-			getRegistry()->emplace<FoodFactoryBuildingComponent>(getEntity(), this);
+			getRegistry()->emplace<FoodFactoryBuildingComponent>(getEntity(), this, game::getSimulationTime(*getRegistry()));
 			getRegistry()->emplace<Produces<Food>>(getEntity());
 			getRegistry()->emplace<Consumes<Biomass>>(getEntity());
 		}
+
+		resourceProcessor.schedule(*getRegistry(), getEntity());
+
+		game::systems::setJobCapacity(*getRegistry(), getEntity(), JOBS_PER_WORKPLACE_FLOOR * getTotalAmountOfActualOccupiedSpace());
 	}
 
 	void FoodFactoryBuilding::__removedFromCell(Cell* cell)
 	{
-		// Nothing to do here...
+		if (getTotalAmountOfActualOccupiedSpace() > 0)
+			resourceProcessor.schedule(*getRegistry(), getEntity());
+
+		game::systems::setJobCapacity(*getRegistry(), getEntity(), JOBS_PER_WORKPLACE_FLOOR * getTotalAmountOfActualOccupiedSpace());
 	}
 
 	void FoodFactoryBuilding::inventoryUpdated()
 	{
-		// Nothing to do here...
+		// Deliveries of biomass may allow the building to resume its production.
+		if (getRegistry()->valid(getEntity()) && getRegistry()->has<FoodFactoryBuildingComponent>(getEntity()))
+			resourceProcessor.schedule(*getRegistry(), getEntity());
 	}
 
 	const Inventory& FoodFactoryBuilding::getResourcesRequiredToBuild()
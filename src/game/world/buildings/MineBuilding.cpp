@@ -4,8 +4,8 @@ namespace game::world
 {
 	static const std::string buildingTypeName = "Mine";
 	static const std::string buildingDescription = "A mine. Mines stone and ore from deep under the ground.";
-	static const Inventory constructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Stone>(4.0f) });
-	static const Inventory destructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Stone>(2.0f) });
+	static const Inventory constructionResources = Inventory({ { itemTypeIndex<Stone>, 4.0f } });
+	static const Inventory destructionResources = Inventory({ { itemTypeIndex<Stone>, 2.0f } });
 
 	static std::shared_ptr<BuildingPieceSet> pieceSet = std::make_shared<BuildingPieceSet>(
 		std::vector<std::shared_ptr<StraightEdgeBuildingPiece>>{ std::make_shared<StraightEdgeBuildingPiece>(
@@ -132,30 +132,58 @@ namespace game::world
 
 	struct MineBuildingComponent
 	{
-		MineBuildingComponent(MineBuilding* _building) : building(_building), lastProduced(glfwGetTime()) {}
+		MineBuildingComponent(MineBuilding* _building, double time)
+			: building(_building), lastProduced(time), nextProduction(-1.0), productionSteps(1) {}
 
 		MineBuilding* building;
 		double lastProduced;
+		double nextProduction;
+		unsigned int productionSteps;
 	};
 
+	static constexpr double productionInterval = 30.0;
+
 	static class MineResourceProcessor : public game::systems::IResourceProcessor {
-		void processResources(entt::registry& registry, double deltaTime)
+	public:
+		void processResources(entt::registry& registry, entt::entity entity, double scheduledTime)
+		{
+			auto* building = registry.try_get<MineBuildingComponent>(entity);
+			if (building == nullptr || building->nextProduction != scheduledTime)
+				return;
+
+			building->lastProduced = scheduledTime;
+			produce(registry, entity, *building, building->productionSteps);
+
+			schedule(registry, entity);
+		}
+
+		void catchUp(entt::registry& registry, entt::entity entity, double time)
+		{
+			auto* building = registry.try_get<MineBuildingComponent>(entity);
+			if (building == nullptr || building->productionSteps == 1)
+				return;
+
+			unsigned int dueSteps = (unsigned int) ((time - building->lastProduced) / productionInterval);
+			building->lastProduced += dueSteps * productionInterval;
+			produce(registry, entity, *building, dueSteps);
+
+			schedule(registry, entity);
+		}
+
+		void schedule(entt::registry& registry, entt::entity entity)
+		{
+			auto& building = registry.get<MineBuildingComponent>(entity);
+			building.productionSteps = game::systems::getSimulationSteps(registry, entity);
+			building.nextProduction = building.lastProduced + building.productionSteps * productionInterval;
+			game::systems::scheduleResourceProcessing(registry, this, entity, building.nextProduction);
+		}
+
+	private:
+		void produce(entt::registry& registry, entt::entity entity, MineBuildingComponent& building, unsigned int steps)
 		{
-			double time = glfwGetTime();
-
-			for (auto& entity : registry.view<MineBuildingComponent>())
-			{
-				registry.patch<MineBuildingComponent>(entity, [&registry, entity, time](auto& building) {
-					if (time - building.lastProduced > 30.0f)
-					{
-						building.lastProduced = time;
-
-						float occupiedSpace = building.building->getTotalAmountOfActualOccupiedSpace();
-						registry.get<Inventory>(entity).addItemTyped<Stone>(1.0f * occupiedSpace);
-						registry.get<Inventory>(entity).addItemTyped<Ores>(0.5f * occupiedSpace);
-					}
-				});
-			}
+			float occupiedSpace = building.building->getTotalAmountOfActualOccupiedSpace();
+			registry.get<Inventory>(entity).addItemTyped<Stone>(1.0f * occupiedSpace * steps);
+			registry.get<Inventory>(entity).addItemTyped<Ores>(0.5f * occupiedSpace * steps);
 		}
 	} resourceProcessor;
 
@@ -171,19 +199,22 @@ namespace game::world
 
 	void MineBuilding::__addedToCell(Cell* cell)
 	{
-		game::systems::attachResourceProcessor(&resourceProcessor);
-
 		if (!getRegistry()->has<MineBuildingComponent>(getEntity()))
 		{
-			getRegistry()->emplace<MineBuildingComponent>(getEntity(), this);
+			getRegistry()->emplace<MineBuildingComponent>(getEntity(), this, game::getSimulationTime(*getRegistry()));
 			getRegistry()->emplace<Produces<Stone>>(getEntity());
 			getRegistry()->emplace<Produces<Ores>>(getEntity());
+
+			// The production interval doesn't depend on the occupied space, so the mine only needs to be scheduled once.
+			resourceProcessor.schedule(*getRegistry(), getEntity());
 		}
+
+		game::systems::setJobCapacity(*getRegistry(), getEntity(), JOBS_PER_WORKPLACE_FLOOR * getTotalAmountOfActualOccupiedSpace());
 	}
 
 	void MineBuilding::__removedFromCell(Cell* cell)
 	{
-		// Nothing to do here...
+		game::systems::setJobCapacity(*getRegistry(), getEntity(), JOBS_PER_WORKPLACE_FLOOR * getTotalAmountOfActualOccupiedSpace());
 	}
 
 	void MineBuilding::inventoryUpdated()
@@ -4,8 +4,8 @@ namespace game::world
 {
 	static const std::string buildingTypeName = "Forest House";
 	static const std::string buildingDescription = "Plants trees within its neighborhood, consuming biomass.";
-	static const Inventory constructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Wood>(4.0f) });
-	static const Inventory destructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Wood>(2.0f) });
+	static const Inventory constructionResources = Inventory({ { itemTypeIndex<Wood>, 4.0f } });
+	static const Inventory destructionResources = Inventory({ { itemTypeIndex<Wood>, 2.0f } });
 
 	static std::shared_ptr<BuildingPieceSet> pieceSet = std::make_shared<BuildingPieceSet>(
 		std::vector<std::shared_ptr<StraightEdgeBuildingPiece>>{ std::make_shared<StraightEdgeBuildingPiece>(
@@ -132,57 +132,114 @@ namespace game::world
 
 	struct ReforesterBuildingComponent
 	{
-		ReforesterBuildingComponent(ReforesterBuilding* _building) : building(_building), lastProduced(glfwGetTime()) {}
+		ReforesterBuildingComponent(ReforesterBuilding* _building, double time)
+			: building(_building), lastProduced(time), nextProduction(-1.0), productionSteps(1) {}
 
 		ReforesterBuilding* building;
 		double lastProduced;
+
+		// The time of the next production, or a negative value while the building waits for biomass.
+		double nextProduction;
+		unsigned int productionSteps;
 	};
 
 	static class ReforesterResourceProcessor : public game::systems::IResourceProcessor {
-		void processResources(entt::registry& registry, double deltaTime)
+	public:
+		void processResources(entt::registry& registry, entt::entity entity, double scheduledTime)
+		{
+			auto* building = registry.try_get<ReforesterBuildingComponent>(entity);
+			if (building == nullptr || building->nextProduction != scheduledTime)
+				return;
+
+			Inventory& inventory = registry.get<Inventory>(entity);
+			if (!hasEnoughBiomass(inventory))
+			{
+				building->nextProduction = -1.0;
+				return;
+			}
+
+			building->lastProduced = scheduledTime;
+			produce(inventory, *building, building->productionSteps);
+
+			schedule(registry, entity);
+		}
+
+		void catchUp(entt::registry& registry, entt::entity entity, double time)
+		{
+			auto* building = registry.try_get<ReforesterBuildingComponent>(entity);
+			if (building == nullptr || building->productionSteps == 1 || building->nextProduction < 0.0)
+				return;
+
+			double timeForProduction = getTimeForProduction(*building);
+			unsigned int dueSteps = (unsigned int) ((time - building->lastProduced) / timeForProduction);
+			building->lastProduced += dueSteps * timeForProduction;
+			produce(registry.get<Inventory>(entity), *building, dueSteps);
+
+			schedule(registry, entity);
+		}
+
+		// (Re)schedules the next production. Must be called whenever the occupied space or the inventory of the building
+		// changes. While there is not enough biomass, the building isn't scheduled at all.
+		void schedule(entt::registry& registry, entt::entity entity)
+		{
+			auto& building = registry.get<ReforesterBuildingComponent>(entity);
+			if (!hasEnoughBiomass(registry.get<Inventory>(entity)))
+			{
+				building.nextProduction = -1.0;
+				return;
+			}
+
+			// The production time only starts to elapse once there is enough biomass.
+			if (building.nextProduction < 0.0)
+				building.lastProduced = game::getSimulationTime(registry);
+
+			building.productionSteps = game::systems::getSimulationSteps(registry, entity);
+
+			double nextProduction = building.lastProduced + building.productionSteps * getTimeForProduction(building);
+			if (nextProduction != building.nextProduction)
+			{
+				building.nextProduction = nextProduction;
+				game::systems::scheduleResourceProcessing(registry, this, entity, nextProduction);
+			}
+		}
+
+	private:
+		bool hasEnoughBiomass(Inventory& inventory)
 		{
-			double time = glfwGetTime();
+			return inventory.getStoredAmountTyped<Biomass>() >= 0.1f;
+		}
 
-			for (auto& entity : registry.view<ReforesterBuildingComponent>())
+		double getTimeForProduction(ReforesterBuildingComponent& building)
+		{
+			float occupiedSpace = building.building->getTotalAmountOfActualOccupiedSpace();
+			return 15.0f + 30.0f / occupiedSpace;
+		}
+
+		// Plants one tree per step for as long as there is enough biomass.
+		void produce(Inventory& inventory, ReforesterBuildingComponent& building, unsigned int steps)
+		{
+			if (steps == 0)
+				return;
+
+			auto& cells = building.building->getCells();
+			std::random_device rd;
+			std::mt19937 gen(rd());
+			std::uniform_int_distribution<> distr(0, cells.size() - 1);
+
+			for (unsigned int step = 0; step < steps && hasEnoughBiomass(inventory); step++)
 			{
-				registry.patch<ReforesterBuildingComponent>(entity, [&registry, entity, time](auto& building) {
-					float occupiedSpace = building.building->getTotalAmountOfActualOccupiedSpace();
-					float requiredBiomass = 0.1f;
-
-					Inventory& inventory = registry.get<Inventory>(entity);
-					std::shared_ptr<Biomass> biomass = inventory.getItemTyped<Biomass>();
-					bool hasEnoughBiomass = biomass != nullptr && biomass->amount >= requiredBiomass;
-
-					if (hasEnoughBiomass)
-					{
-						float timeForProduction = 15.0f + 30.0f / occupiedSpace;
-						if (time - building.lastProduced > timeForProduction)
-						{
-							building.lastProduced = time;
-
-							auto& cells = building.building->getCells();
-							std::random_device rd;
-							std::mt19937 gen(rd());
-							std::uniform_int_distribution<> distr(0, cells.size() - 1);
-							auto& randomCell = std::next(std::begin(cells), distr(gen));
-
-							Cell* treeCell = randomCell->first->getAnyNeighborFulfillingPredicate(10, std::function<bool(Cell*)>([](Cell* cell) {
-								CellContent* cellContent = cell->getContent();
-								return cellContent == nullptr && cell->getCellType() == CellType::GRASS;
-								}));
-
-							if (treeCell != nullptr)
-							{
-								treeCell->setContent(new Tree());
-
-								inventory.removeItemTyped<Biomass>(requiredBiomass);
-							}
-						}
-					}
-					else {
-						building.lastProduced = time;
-					}
-					});
+				auto randomCell = std::next(std::begin(cells), distr(gen));
+
+				Cell* treeCell = randomCell->first->getAnyNeighborFulfillingPredicate(10, std::function<bool(Cell*)>([](Cell* cell) {
+					CellContent* cellContent = cell->getContent();
+					return cellContent == nullptr && cell->getCellType() == CellType::GRASS;
+				}));
+
+				if (treeCell == nullptr)
+					break;
+
+				treeCell->setContent(new Tree());
+				inventory.removeItemTyped<Biomass>(0.1f);
 			}
 		}
 	} resourceProcessor;
@@ -199,23 +256,30 @@ namespace game::world
 
 	void ReforesterBuilding::__addedToCell(Cell* cell)
 	{
-		game::systems::attachResourceProcessor(&resourceProcessor);
-
 		if (!getRegistry()->has<ReforesterBuildingComponent>(getEntity()))
 		{
-			getRegistry()->emplace<ReforesterBuildingComponent>(getEntity(), this);
+			getRegistry()->emplace<ReforesterBuildingComponent>(getEntity(), this, game::getSimulationTime(*getRegistry()));
 			getRegistry()->emplace<Consumes<Biomass>>(getEntity());
 		}
+
+		resourceProcessor.schedule(*getRegistry(), getEntity());
+
+		game::systems::setJobCapacity(*getRegistry(), getEntity(), JOBS_PER_WORKPLACE_FLOOR * getTotalAmountOfActualOccupiedSpace());
 	}
 
 	void ReforesterBuilding::__removedFromCell(Cell* cell)
 	{
-		// Nothing to do here...
+		if (getTotalAmountOfActualOccupiedSpace() > 0)
+			resourceProcessor.schedule(*getRegistry(), getEntity());
+
+		game::systems::setJobCapacity(*getRegistry(), getEntity(), JOBS_PER_WORKPLACE_FLOOR * getTotalAmountOfActualOccupiedSpace());
 	}
 
 	void ReforesterBuilding::inventoryUpdated()
 	{
-		// Nothing to do here...
+		// Deliveries of biomass may allow the building to resume its production.
+		if (getRegistry()->valid(getEntity()) && getRegistry()->has<ReforesterBuildingComponent>(getEntity()))
+			resourceProcessor.schedule(*getRegistry(), getEntity());
 	}
 
 	const Inventory& ReforesterBuilding::getResourcesRequiredToBuild()
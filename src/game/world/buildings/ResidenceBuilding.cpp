@@ -4,8 +4,8 @@ namespace game::world
 {
 	static const std::string buildingTypeName = "Residence Building";
 	static const std::string buildingDescription = "A habitat for your citizens. Consumes food.";
-	static const Inventory constructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Wood>(1.0f), std::make_shared<Stone>(2.0f) });
-	static const Inventory destructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Wood>(0.5f), std::make_shared<Stone>(1.0f) });
+	static const Inventory constructionResources = Inventory({ { itemTypeIndex<Wood>, 1.0f }, { itemTypeIndex<Stone>, 2.0f } });
+	static const Inventory destructionResources = Inventory({ { itemTypeIndex<Wood>, 0.5f }, { itemTypeIndex<Stone>, 1.0f } });
 
 	static std::shared_ptr<BuildingPieceSet> pieceSet = std::make_shared<BuildingPieceSet>(
 		std::vector<std::shared_ptr<StraightEdgeBuildingPiece>>{ std::make_shared<StraightEdgeBuildingPiece>(
@@ -132,34 +132,63 @@ namespace game::world
 
 	struct ResidenceBuildingComponent
 	{
-		ResidenceBuildingComponent(ResidenceBuilding* _building) : building(_building), lastConsumed(glfwGetTime()) {}
+		ResidenceBuildingComponent(ResidenceBuilding* _building, double time)
+			: building(_building), lastConsumed(time), nextConsumption(-1.0), consumptionSteps(1) {}
 
 		ResidenceBuilding* building;
 		double lastConsumed;
+		double nextConsumption;
+		unsigned int consumptionSteps;
 	};
 
+	static constexpr double consumptionInterval = 120.0;
+
 	static class ResidenceResourceProcessor : public game::systems::IResourceProcessor {
-		void processResources(entt::registry& registry, double deltaTime)
+	public:
+		void processResources(entt::registry& registry, entt::entity entity, double scheduledTime)
+		{
+			auto* building = registry.try_get<ResidenceBuildingComponent>(entity);
+			if (building == nullptr || building->nextConsumption != scheduledTime)
+				return;
+
+			building->lastConsumed = scheduledTime;
+			consume(registry, entity, *building, building->consumptionSteps);
+
+			schedule(registry, entity);
+		}
+
+		void catchUp(entt::registry& registry, entt::entity entity, double time)
 		{
-			double time = glfwGetTime();
-
-			for (auto& entity : registry.view<ResidenceBuildingComponent>())
-			{
-				registry.patch<ResidenceBuildingComponent>(entity, [&registry, entity, time](auto& building) {
-					if (time - building.lastConsumed > 120.0f)
-					{
-						building.lastConsumed = time;
-
-						float amountToConsume = 0.1f * building.building->getTotalAmountOfActualOccupiedSpace();
-						std::shared_ptr<Food> consumedFood = registry.get<Inventory>(entity).removeItemTyped<Food>(amountToConsume);
-						if (consumedFood == nullptr || consumedFood->amount != amountToConsume)
-						{
-							// TODO: Building didn't have enough food to feed all citizens. What to do now? Should the building (or
-							// some part of it) be removed?
-						}
-					}
-				});
-			}
+			auto* building = registry.try_get<ResidenceBuildingComponent>(entity);
+			if (building == nullptr || building->consumptionSteps == 1)
+				return;
+
+			unsigned int dueSteps = (unsigned int) ((time - building->lastConsumed) / consumptionInterval);
+			building->lastConsumed += dueSteps * consumptionInterval;
+			consume(registry, entity, *building, dueSteps);
+
+			schedule(registry, entity);
+		}
+
+		void schedule(entt::registry& registry, entt::entity entity)
+		{
+			auto& building = registry.get<ResidenceBuildingComponent>(entity);
+			building.consumptionSteps = game::systems::getSimulationSteps(registry, entity);
+			building.nextConsumption = building.lastConsumed + building.consumptionSteps * consumptionInterval;
+			game::systems::scheduleResourceProcessing(registry, this, entity, building.nextConsumption);
+		}
+
+	private:
+		void consume(entt::registry& registry, entt::entity entity, ResidenceBuildingComponent& building, unsigned int steps)
+		{
+			if (steps == 0)
+				return;
+
+			// Residents which don't get enough food become hungry and eventually starve (see the population system).
+			auto& residents = registry.get<game::systems::Residents>(entity);
+			float amountToConsume = CITIZEN_FOOD_PER_MEAL * residents.amount * steps;
+			float consumedFood = registry.get<Inventory>(entity).removeItemTyped<Food>(amountToConsume);
+			residents.foodSupply = amountToConsume > 0.0f ? consumedFood / amountToConsume : 1.0f;
 		}
 	} resourceProcessor;
 
@@ -175,18 +204,23 @@ namespace game::world
 
 	void ResidenceBuilding::__addedToCell(Cell* cell)
 	{
-		game::systems::attachResourceProcessor(&resourceProcessor);
-
 		if (!getRegistry()->has<ResidenceBuildingComponent>(getEntity()))
 		{
-			getRegistry()->emplace<ResidenceBuildingComponent>(getEntity(), this);
+			getRegistry()->emplace<ResidenceBuildingComponent>(getEntity(), this, game::getSimulationTime(*getRegistry()));
 			getRegistry()->emplace<Consumes<Food>>(getEntity());
+
+			// The consumption interval doesn't depend on the occupied space, so the residence only needs to be scheduled once.
+			resourceProcessor.schedule(*getRegistry(), getEntity());
 		}
+
+		unsigned int capacity = CITIZENS_PER_RESIDENCE_FLOOR * getTotalAmountOfActualOccupiedSpace();
+		game::systems::setResidentCapacity(*getRegistry(), getEntity(), cell->getCompleteId(), capacity);
 	}
 
 	void ResidenceBuilding::__removedFromCell(Cell* cell)
 	{
-		// Nothing to do here...
+		unsigned int capacity = CITIZENS_PER_RESIDENCE_FLOOR * getTotalAmountOfActualOccupiedSpace();
+		game::systems::setResidentCapacity(*getRegistry(), getEntity(), cell->getCompleteId(), capacity);
 	}
 
 	void ResidenceBuilding::inventoryUpdated()
@@ -4,8 +4,8 @@ namespace game::world
 {
 	static const std::string buildingTypeName = "Storage Building";
 	static const std::string buildingDescription = "A building to store excess items.";
-	static const Inventory constructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Stone>(4.0f) });
-	static const Inventory destructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Stone>(2.0f) });
+	static const Inventory constructionResources = Inventory({ { itemTypeIndex<Stone>, 4.0f } });
+	static const Inventory destructionResources = Inventory({ { itemTypeIndex<Stone>, 2.0f } });
 
 	static std::shared_ptr<BuildingPieceSet> pieceSet = std::make_shared<BuildingPieceSet>(
 		std::vector<std::shared_ptr<StraightEdgeBuildingPiece>>{ std::make_shared<StraightEdgeBuildingPiece>(
@@ -135,6 +135,14 @@ namespace game::world
 		std::unordered_set<Cell*> cellsToCopy
 	) : Building(buildingTypeName, buildingDescription, pieceSet, original, cellsToCopy) {}
 
+	StorageBuilding::~StorageBuilding()
+	{
+		// The type representative is never added to a world, so it has no registry whose warehouse index it could be
+		// removed from.
+		if (getEntity() != entt::null)
+			game::systems::removeStorageFromWarehouseIndex(*getRegistry(), getEntity());
+	}
+
 	bool StorageBuilding::_canBePlacedOnCell(Cell* cell)
 	{
 		return true;
@@ -147,16 +155,31 @@ namespace game::world
 		getRegistry()->emplace_or_replace<Stores<Ores>>(getEntity());
 		getRegistry()->emplace_or_replace<Stores<Biomass>>(getEntity());
 		getRegistry()->emplace_or_replace<Stores<Food>>(getEntity());
+
+		updateWarehouseIndexCells();
 	}
 
 	void StorageBuilding::__removedFromCell(Cell* cell)
 	{
-		// Nothing to do here...
+		updateWarehouseIndexCells();
+	}
+
+	void StorageBuilding::updateWarehouseIndexCells()
+	{
+		// The storage is indexed in the regions of all of its cells, so that searching the regions around a position finds
+		// the storage no later than in the region of its nearest cell.
+		std::vector<glm::vec2> cellPositions;
+		for (const auto& cellAndHeight : getHeightPerCell())
+			if (cellAndHeight.second.actualHeight > 0)
+				cellPositions.push_back(cellAndHeight.first->getRelaxedPosition());
+
+		game::systems::setStorageCellsInWarehouseIndex(*getRegistry(), getEntity(), cellPositions);
 	}
 
 	void StorageBuilding::inventoryUpdated()
 	{
-		// Nothing to do here...
+		if (getRegistry()->valid(getEntity()))
+			game::systems::updateStorageInWarehouseIndex(*getRegistry(), getEntity());
 	}
 
 	const Inventory& StorageBuilding::getResourcesRequiredToBuild()
@@ -9,7 +9,7 @@ namespace game::world
 	public:
 		StorageBuilding(IBuilding* original, std::unordered_set<Cell*> cellsToCopy);
 
-		virtual ~StorageBuilding() {}
+		virtual ~StorageBuilding();
 
 		void inventoryUpdated();
 
@@ -23,5 +23,8 @@ namespace game::world
 		void __addedToCell(Cell* cell);
 
 		void __removedFromCell(Cell* cell);
+
+	private:
+		void updateWarehouseIndexCells();
 	};
 }
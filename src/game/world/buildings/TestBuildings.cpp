@@ -4,13 +4,13 @@ namespace game::world
 {
 	static const std::string testBuildingTypeName = "TestBuilding";
 	static const std::string testBuildingDescription = "A building which consumes one unit of wood each 15 seconds. If it doesn't have any wood to consume, it will get destroyed over time.";
-	static const Inventory testBuildingConstructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Wood>(5.0f) });
-	static const Inventory testBuildingDestructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Wood>(2.5f) });
+	static const Inventory testBuildingConstructionResources = Inventory({ { itemTypeIndex<Wood>, 5.0f } });
+	static const Inventory testBuildingDestructionResources = Inventory({ { itemTypeIndex<Wood>, 2.5f } });
 
 	static const std::string otherTestBuildingTypeName = "OtherTestBuilding";
 	static const std::string otherTestBuildingDescription = "A building which produces one unit of wood each 5 seconds.";
-	static const Inventory otherTestBuildingConstructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Wood>(4.0f) });
-	static const Inventory otherTestBuildingDestructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Wood>(2.0f) });
+	static const Inventory otherTestBuildingConstructionResources = Inventory({ { itemTypeIndex<Wood>, 4.0f } });
+	static const Inventory otherTestBuildingDestructionResources = Inventory({ { itemTypeIndex<Wood>, 2.0f } });
 
 	static std::shared_ptr<BuildingPieceSet> testBuildingPieceSet = std::make_shared<BuildingPieceSet>(
 		std::vector<std::shared_ptr<StraightEdgeBuildingPiece>>{ std::make_shared<StraightEdgeBuildingPiece>(
@@ -137,60 +137,74 @@ namespace game::world
 
 	struct TestBuildingComponent
 	{
-		TestBuildingComponent(TestBuilding* _building) : building(_building), lastConsumed(glfwGetTime()) {}
+		TestBuildingComponent(TestBuilding* _building, double time) : building(_building), lastConsumed(time), nextConsumption(-1.0) {}
 
 		TestBuilding* building;
 		double lastConsumed;
+		double nextConsumption;
 	};
 
 	struct OtherTestBuildingComponent
 	{
-		OtherTestBuildingComponent(OtherTestBuilding* _building) : building(_building), lastProduced(glfwGetTime()) {}
+		OtherTestBuildingComponent(OtherTestBuilding* _building, double time) : building(_building), lastProduced(time), nextProduction(-1.0) {}
 
 		OtherTestBuilding* building;
 		double lastProduced;
+		double nextProduction;
 	};
 
-	static class TestBuildingsResourceProcessor : public game::systems::IResourceProcessor {
-		void processResources(entt::registry& registry, double deltaTime)
+	static class TestBuildingResourceProcessor : public game::systems::IResourceProcessor {
+	public:
+		void processResources(entt::registry& registry, entt::entity entity, double scheduledTime)
 		{
-			double time = glfwGetTime();
+			auto* building = registry.try_get<TestBuildingComponent>(entity);
+			if (building == nullptr || building->nextConsumption != scheduledTime)
+				return;
 
-			for (auto& entity : registry.view<TestBuildingComponent>())
-			{
-				registry.patch<TestBuildingComponent>(entity, [&registry, entity, time](auto& building) {
-					if (time - building.lastConsumed > 15.0f)
-					{
-						building.lastConsumed = time;
-
-						std::shared_ptr<Wood> wood = registry.get<Inventory>(entity).getItemTyped<Wood>();
-						bool removeBuilding = true;
-						if (wood != nullptr && wood->amount >= 1.0f)
-						{
-							removeBuilding = false;
-							wood->amount -= 1.0f;
-						}
+			building->lastConsumed = scheduledTime;
 
-						if (removeBuilding)
-							building.building->getCells().begin()->first->setContent(nullptr);
-					}
-				});
+			Inventory& inventory = registry.get<Inventory>(entity);
+			if (inventory.getStoredAmountTyped<Wood>() < 1.0f)
+			{
+				// Removing the building destroys its entity, so it must not be scheduled again.
+				building->building->getCells().begin()->first->setContent(nullptr);
+				return;
 			}
 
-			for (auto& entity : registry.view<OtherTestBuildingComponent>())
-			{
-				registry.patch<OtherTestBuildingComponent>(entity, [&registry, entity, time](auto& building) {
-					if (time - building.lastProduced > 5.0f)
-					{
-						building.lastProduced = time;
+			inventory.removeItemTyped<Wood>(1.0f);
+			schedule(registry, entity);
+		}
 
-						registry.get<Inventory>(entity).addItemTyped<Wood>(1.0f);
-					}
-				});
-			}
+		void schedule(entt::registry& registry, entt::entity entity)
+		{
+			auto& building = registry.get<TestBuildingComponent>(entity);
+			building.nextConsumption = building.lastConsumed + 15.0f;
+			game::systems::scheduleResourceProcessing(registry, this, entity, building.nextConsumption);
 		}
 	} testBuildingResourceProcessor;
 
+	static class OtherTestBuildingResourceProcessor : public game::systems::IResourceProcessor {
+	public:
+		void processResources(entt::registry& registry, entt::entity entity, double scheduledTime)
+		{
+			auto* building = registry.try_get<OtherTestBuildingComponent>(entity);
+			if (building == nullptr || building->nextProduction != scheduledTime)
+				return;
+
+			building->lastProduced = scheduledTime;
+			registry.get<Inventory>(entity).addItemTyped<Wood>(1.0f);
+
+			schedule(registry, entity);
+		}
+
+		void schedule(entt::registry& registry, entt::entity entity)
+		{
+			auto& building = registry.get<OtherTestBuildingComponent>(entity);
+			building.nextProduction = building.lastProduced + 5.0f;
+			game::systems::scheduleResourceProcessing(registry, this, entity, building.nextProduction);
+		}
+	} otherTestBuildingResourceProcessor;
+
 	TestBuilding::TestBuilding(
 		IBuilding* original,
 		std::unordered_set<Cell*> cellsToCopy
@@ -203,12 +217,11 @@ namespace game::world
 
 	void TestBuilding::__addedToCell(Cell* cell)
 	{
-		game::systems::attachResourceProcessor(&testBuildingResourceProcessor);
-
 		if (!getRegistry()->has<TestBuildingComponent>(getEntity()))
 		{
-			getRegistry()->emplace<TestBuildingComponent>(getEntity(), this);
+			getRegistry()->emplace<TestBuildingComponent>(getEntity(), this, game::getSimulationTime(*getRegistry()));
 			getRegistry()->emplace<Consumes<Wood>>(getEntity());
+			testBuildingResourceProcessor.schedule(*getRegistry(), getEntity());
 		}
 	}
 
@@ -244,12 +257,11 @@ namespace game::world
 
 	void OtherTestBuilding::__addedToCell(Cell* cell)
 	{
-		game::systems::attachResourceProcessor(&testBuildingResourceProcessor);
-
 		if (!getRegistry()->has<OtherTestBuildingComponent>(getEntity()))
 		{
-			getRegistry()->emplace<OtherTestBuildingComponent>(getEntity(), this);
+			getRegistry()->emplace<OtherTestBuildingComponent>(getEntity(), this, game::getSimulationTime(*getRegistry()));
 			getRegistry()->emplace<Produces<Wood>>(getEntity());
+			otherTestBuildingResourceProcessor.schedule(*getRegistry(), getEntity());
 		}
 	}
 
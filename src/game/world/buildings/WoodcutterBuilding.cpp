@@ -4,8 +4,8 @@ namespace game::world
 {
 	static const std::string buildingTypeName = "Woodcutter";
 	static const std::string buildingDescription = "Cuts trees within its neighborhood to produce wood and biomass.";
-	static const Inventory constructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Wood>(4.0f) });
-	static const Inventory destructionResources = Inventory(std::unordered_set<std::shared_ptr<IItem>, IItemHash, IItemComparator>{ std::make_shared<Wood>(2.0f) });
+	static const Inventory constructionResources = Inventory({ { itemTypeIndex<Wood>, 4.0f } });
+	static const Inventory destructionResources = Inventory({ { itemTypeIndex<Wood>, 2.0f } });
 
 	static std::shared_ptr<BuildingPieceSet> pieceSet = std::make_shared<BuildingPieceSet>(
 		std::vector<std::shared_ptr<StraightEdgeBuildingPiece>>{ std::make_shared<StraightEdgeBuildingPiece>(
@@ -132,48 +132,92 @@ namespace game::world
 
 	struct WoodcutterBuildingComponent
 	{
-		WoodcutterBuildingComponent(WoodcutterBuilding* _building) : building(_building), lastProduced(glfwGetTime()) {}
+		WoodcutterBuildingComponent(WoodcutterBuilding* _building, double time)
+			: building(_building), lastProduced(time), nextProduction(-1.0), productionSteps(1) {}
 
 		WoodcutterBuilding* building;
 		double lastProduced;
+		double nextProduction;
+		unsigned int productionSteps;
 	};
 
 	static class WoodcutterResourceProcessor : public game::systems::IResourceProcessor {
-		void processResources(entt::registry& registry, double deltaTime)
+	public:
+		void processResources(entt::registry& registry, entt::entity entity, double scheduledTime)
 		{
-			double time = glfwGetTime();
+			auto* building = registry.try_get<WoodcutterBuildingComponent>(entity);
+			if (building == nullptr || building->nextProduction != scheduledTime)
+				return;
 
-			for (auto& entity : registry.view<WoodcutterBuildingComponent>())
+			building->lastProduced = scheduledTime;
+			produce(registry, entity, *building, building->productionSteps);
+
+			schedule(registry, entity);
+		}
+
+		void catchUp(entt::registry& registry, entt::entity entity, double time)
+		{
+			auto* building = registry.try_get<WoodcutterBuildingComponent>(entity);
+			if (building == nullptr || building->productionSteps == 1)
+				return;
+
+			double timeForProduction = getTimeForProduction(*building);
+			unsigned int dueSteps = (unsigned int) ((time - building->lastProduced) / timeForProduction);
+			building->lastProduced += dueSteps * timeForProduction;
+			produce(registry, entity, *building, dueSteps);
+
+			schedule(registry, entity);
+		}
+
+		// (Re)schedules the next production. Must be called whenever the occupied space of the building changes.
+		void schedule(entt::registry& registry, entt::entity entity)
+		{
+			auto& building = registry.get<WoodcutterBuildingComponent>(entity);
+			building.productionSteps = game::systems::getSimulationSteps(registry, entity);
+
+			double nextProduction = building.lastProduced + building.productionSteps * getTimeForProduction(building);
+			if (nextProduction != building.nextProduction)
+			{
+				building.nextProduction = nextProduction;
+				game::systems::scheduleResourceProcessing(registry, this, entity, nextProduction);
+			}
+		}
+
+	private:
+		double getTimeForProduction(WoodcutterBuildingComponent& building)
+		{
+			float occupiedSpace = building.building->getTotalAmountOfActualOccupiedSpace();
+			return 15.0f + 30.0f / occupiedSpace;
+		}
+
+		// Cuts down one tree per step. Each tree is searched for separately, so that processing several steps at once cuts
+		// down the same amount of trees as processing them one after another.
+		void produce(entt::registry& registry, entt::entity entity, WoodcutterBuildingComponent& building, unsigned int steps)
+		{
+			if (steps == 0)
+				return;
+
+			auto& cells = building.building->getCells();
+			std::random_device rd;
+			std::mt19937 gen(rd());
+			std::uniform_int_distribution<> distr(0, cells.size() - 1);
+
+			Inventory& inventory = registry.get<Inventory>(entity);
+			for (unsigned int step = 0; step < steps; step++)
 			{
-				registry.patch<WoodcutterBuildingComponent>(entity, [&registry, entity, time](auto& building) {
-					float occupiedSpace = building.building->getTotalAmountOfActualOccupiedSpace();
-					float timeForProduction = 15.0f + 30.0f / occupiedSpace;
-
-					if (time - building.lastProduced > timeForProduction)
-					{
-						building.lastProduced = time;
-
-						auto& cells = building.building->getCells();
-						std::random_device rd;
-						std::mt19937 gen(rd());
-						std::uniform_int_distribution<> distr(0, cells.size() - 1);
-						auto& randomCell = std::next(std::begin(cells), distr(gen));
-
-						Cell* treeCell = randomCell->first->getAnyNeighborFulfillingPredicate(10, std::function<bool(Cell*)>([](Cell* cell) {
-							CellContent* cellContent = cell->getContent();
-							return cellContent != nullptr && dynamic_cast<Tree*>(cellContent) != nullptr;
-						}));
-
-						if (treeCell != nullptr)
-						{
-							treeCell->setContent(nullptr);
-
-							Inventory& inventory = registry.get<Inventory>(entity);
-							inventory.addItemTyped<Wood>(2.0f);
-							inventory.addItemTyped<Biomass>(1.0f);
-						}
-					}
-				});
+				auto randomCell = std::next(std::begin(cells), distr(gen));
+
+				Cell* treeCell = randomCell->first->getAnyNeighborFulfillingPredicate(10, std::function<bool(Cell*)>([](Cell* cell) {
+					CellContent* cellContent = cell->getContent();
+					return cellContent != nullptr && cellContent->is<Tree>();
+				}));
+
+				if (treeCell == nullptr)
+					break;
+
+				treeCell->setContent(nullptr);
+				inventory.addItemTyped<Wood>(2.0f);
+				inventory.addItemTyped<Biomass>(1.0f);
 			}
 		}
 	} resourceProcessor;
@@ -190,19 +234,24 @@ namespace game::world
 
 	void WoodcutterBuilding::__addedToCell(Cell* cell)
 	{
-		game::systems::attachResourceProcessor(&resourceProcessor);
-
 		if (!getRegistry()->has<WoodcutterBuildingComponent>(getEntity()))
 		{
-			getRegistry()->emplace<WoodcutterBuildingComponent>(getEntity(), this);
+			getRegistry()->emplace<WoodcutterBuildingComponent>(getEntity(), this, game::getSimulationTime(*getRegistry()));
 			getRegistry()->emplace<Produces<Wood>>(getEntity());
 			getRegistry()->emplace<Produces<Biomass>>(getEntity());
 		}
+
+		resourceProcessor.schedule(*getRegistry(), getEntity());
+
+		game::systems::setJobCapacity(*getRegistry(), getEntity(), JOBS_PER_WORKPLACE_FLOOR * getTotalAmountOfActualOccupiedSpace());
 	}
 
 	void WoodcutterBuilding::__removedFromCell(Cell* cell)
 	{
-		// Nothing to do here...
+		if (getTotalAmountOfActualOccupiedSpace() > 0)
+			resourceProcessor.schedule(*getRegistry(), getEntity());
+
+		game::systems::setJobCapacity(*getRegistry(), getEntity(), JOBS_PER_WORKPLACE_FLOOR * getTotalAmountOfActualOccupiedSpace());
 	}
 
 	void WoodcutterBuilding::inventoryUpdated()
@@ -0,0 +1,207 @@
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include "Scenario.hpp"
+#include "../game/DayNightCycle.hpp"
+#include "../game/SimulationTime.hpp"
+#include "../game/systems/PopulationSystem.hpp"
+#include "../game/systems/ResourceProcessingSystem.hpp"
+#include "../game/world/Constants.hpp"
+#include "../game/world/Drone.hpp"
+#include "../game/world/World.hpp"
+#include "../game/world/buildings/DroneFactoryBuilding.hpp"
+#include "../game/world/buildings/FoodFactoryBuilding.hpp"
+#include "../game/world/buildings/MineBuilding.hpp"
+#include "../game/world/buildings/ReforesterBuilding.hpp"
+#include "../game/world/buildings/ResidenceBuilding.hpp"
+#include "../game/world/buildings/StorageBuilding.hpp"
+#include "../game/world/buildings/WoodcutterBuilding.hpp"
+#include "../rendering/systems/RenderingSystem.hpp"
+
+using namespace game;
+
+static const std::unordered_map<std::string, world::IBuilding*> buildingTypes{
+	{ "DroneFactory", &world::DroneFactoryBuilding::typeRepresentative },
+	{ "FoodFactory", &world::FoodFactoryBuilding::typeRepresentative },
+	{ "Mine", &world::MineBuilding::typeRepresentative },
+	{ "Reforester", &world::ReforesterBuilding::typeRepresentative },
+	{ "Residence", &world::ResidenceBuilding::typeRepresentative },
+	{ "Storage", &world::StorageBuilding::typeRepresentative },
+	{ "Woodcutter", &world::WoodcutterBuilding::typeRepresentative }
+};
+
+void generateWorld(world::World& world, int worldSize)
+{
+	// Generate the same hexagonal shape of chunks as the game does.
+	size_t amountOfChunks = 0;
+	for (int column = -worldSize; column <= 0; column++)
+		for (int row = -worldSize - column; row <= worldSize; row++, amountOfChunks++)
+			world.generateChunk(row, column);
+	for (int column = 1; column <= worldSize; column++)
+		for (int row = -worldSize; row <= worldSize - column; row++, amountOfChunks++)
+			world.generateChunk(row, column);
+
+	// The chunks are generated on the world generation thread and added to the world one per update. Wait until all
+	// chunks were added, so that every run of a scenario starts with the same world.
+	while (world.getAmountOfChunksAddedToWorld() < amountOfChunks)
+	{
+		world.update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+world::Cell* findNearestSuitableCell(world::World& world, world::IBuilding* buildingType, glm::vec2 position)
+{
+	world::Cell* result = nullptr;
+	float currentSquaredDistance = std::numeric_limits<float>::max();
+
+	for (auto& chunk : world.getChunks())
+	{
+		for (auto& cell : chunk.second->getCells())
+		{
+			float squaredDistanceToCell = glm::distance2(position, cell.second->getRelaxedPosition());
+			if (squaredDistanceToCell < currentSquaredDistance && buildingType->canBePlacedOnCell(cell.second))
+			{
+				result = cell.second;
+				currentSquaredDistance = squaredDistanceToCell;
+			}
+		}
+	}
+
+	return result;
+}
+
+// Reports of worlds running on different threads must not be interleaved.
+static std::mutex reportMutex;
+
+void printReport(entt::registry& registry, size_t worldIndex, size_t tick, double elapsedSeconds)
+{
+	std::map<std::string, float> storedItems;
+	registry.view<world::Inventory>().each([&storedItems](auto entity, world::Inventory& inventory) {
+		inventory.forEachItem([&storedItems](world::IItem* itemType, float amount) {
+			storedItems[itemType->typeName] += amount;
+		});
+	});
+
+	std::ostringstream report;
+	report << "World " << worldIndex << ", tick " << tick
+		<< " (" << getSimulationTime(registry) << " simulated seconds, "
+		<< (elapsedSeconds > 0.0 ? tick / elapsedSeconds : 0.0) << " ticks per second)" << std::endl
+		<< "    Drones: " << registry.view<world::Drone>().size() << std::endl
+		<< "    Citizens: " << systems::getPopulation(registry).size() << std::endl;
+	for (auto& typeNameAndAmount : storedItems)
+		report << "    " << typeNameAndAmount.first << ": " << typeNameAndAmount.second << std::endl;
+
+	std::lock_guard<std::mutex> lock(reportMutex);
+	std::cout << report.str();
+}
+
+// Generates and simulates a single world. Each world has its own registry, so that several worlds can be simulated on
+// different threads at the same time.
+void runWorld(const headless::Scenario& scenario, size_t worldIndex)
+{
+	entt::registry registry;
+	registry.set<DayNightCycle>();
+
+	// There is no rendering system when running headless, but the world still registers its meshes for shading.
+	registry.set<rendering::systems::MeshShading>();
+	registry.set<rendering::systems::Picking>();
+	registry.set<rendering::systems::ShadowMapping>();
+
+	world::World* wrld = new world::World(scenario.seed, registry, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+	generateWorld(*wrld, scenario.worldSize);
+
+	for (glm::vec2 position : scenario.drones)
+	{
+		float height = wrld->getHeightGenerator().getHeight(position.x, position.y) + world::DRONE_FLIGHT_HEIGHT;
+		world::Drone::spawnNewDrone(registry, glm::vec3(position.x, height, position.y));
+	}
+
+	for (const headless::ScenarioBuilding& building : scenario.buildings)
+	{
+		world::IBuilding* buildingType = buildingTypes.at(building.buildingType);
+		world::Cell* cell = findNearestSuitableCell(*wrld, buildingType, building.position);
+		if (cell != nullptr)
+			systems::enqueueConstruction(registry, cell, buildingType);
+		else if (worldIndex == 0)
+			std::cerr << "No suitable cell found for " << building.buildingType << "!" << std::endl;
+	}
+
+	auto& daynight = registry.ctx<DayNightCycle>();
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t tick = 1; tick <= scenario.ticks; tick++)
+	{
+		advanceSimulationTime(registry, scenario.deltaTime);
+		wrld->update();
+		if (scenario.hasFocus)
+			systems::updateSimulationFocus(registry, scenario.focus);
+		systems::updateResourceProcessingSystem(registry, scenario.deltaTime);
+		systems::updatePopulationSystem(registry);
+		daynight.update(scenario.deltaTime);
+
+		if (scenario.reportInterval != 0 && tick % scenario.reportInterval == 0)
+		{
+			std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+			printReport(registry, worldIndex, tick, elapsed.count());
+		}
+	}
+	std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+	printReport(registry, worldIndex, scenario.ticks, elapsed.count());
+
+	registry.clear();
+	delete wrld;
+}
+
+int main(int argc, char** argv)
+{
+	std::string scenarioFileName = argc > 1 ? argv[1] : "./res/scenarios/default.scenario";
+
+	headless::Scenario scenario;
+	try
+	{
+		scenario = headless::Scenario::load(scenarioFileName);
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << exception.what() << std::endl;
+		return 1;
+	}
+
+	for (const headless::ScenarioBuilding& building : scenario.buildings)
+	{
+		if (buildingTypes.find(building.buildingType) == buildingTypes.end())
+		{
+			std::cerr << "Unknown building type " << building.buildingType << "!" << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << "Running " << scenario.ticks << " ticks of scenario " << scenarioFileName << " in " << scenario.worlds
+		<< " world(s)" << std::endl;
+
+	if (scenario.worlds == 1)
+	{
+		runWorld(scenario, 0);
+		return 0;
+	}
+
+	std::vector<std::thread> threads;
+	for (size_t worldIndex = 0; worldIndex < scenario.worlds; worldIndex++)
+		threads.emplace_back(runWorld, std::cref(scenario), worldIndex);
+	for (std::thread& thread : threads)
+		thread.join();
+}
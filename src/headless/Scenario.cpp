@@ -0,0 +1,65 @@
+#include "Scenario.hpp"
+
+namespace headless
+{
+	Scenario Scenario::load(const std::string& fileName)
+	{
+		std::ifstream file(fileName);
+		if (!file.is_open())
+			throw std::runtime_error("Could not open scenario file " + fileName + "!");
+
+		Scenario scenario;
+
+		std::string line;
+		size_t lineNumber = 0;
+		while (std::getline(file, line))
+		{
+			lineNumber++;
+
+			std::istringstream stream(line);
+			std::string keyword;
+			if (!(stream >> keyword) || keyword[0] == '#')
+				continue;
+
+			bool valid;
+			if (keyword == "seed")
+				valid = (bool)(stream >> scenario.seed);
+			else if (keyword == "worldSize")
+				valid = (bool)(stream >> scenario.worldSize);
+			else if (keyword == "ticks")
+				valid = (bool)(stream >> scenario.ticks);
+			else if (keyword == "deltaTime")
+				valid = (bool)(stream >> scenario.deltaTime);
+			else if (keyword == "reportInterval")
+				valid = (bool)(stream >> scenario.reportInterval);
+			else if (keyword == "worlds")
+				valid = (bool)(stream >> scenario.worlds) && scenario.worlds > 0;
+			else if (keyword == "drone")
+			{
+				glm::vec2 position;
+				valid = (bool)(stream >> position.x >> position.y);
+				scenario.drones.push_back(position);
+			}
+			else if (keyword == "focus")
+			{
+				valid = (bool)(stream >> scenario.focus.x >> scenario.focus.y);
+				scenario.hasFocus = true;
+			}
+			else if (keyword == "build")
+			{
+				ScenarioBuilding building;
+				valid = (bool)(stream >> building.buildingType >> building.position.x >> building.position.y);
+				scenario.buildings.push_back(building);
+			}
+			else
+			{
+				throw std::runtime_error(fileName + ":" + std::to_string(lineNumber) + ": Unknown keyword " + keyword + "!");
+			}
+
+			if (!valid)
+				throw std::runtime_error(fileName + ":" + std::to_string(lineNumber) + ": Invalid arguments for " + keyword + "!");
+		}
+
+		return scenario;
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace headless
+{
+	struct ScenarioBuilding
+	{
+		std::string buildingType;
+		glm::vec2 position;
+	};
+
+	// A scenario describes a headless simulation run. Scenarios are stored as plain text files where each line contains
+	// a single keyword followed by its arguments. Empty lines and lines starting with '#' are ignored. The following
+	// keywords are supported:
+	//     seed <seed>                  The seed of the world to generate.
+	//     worldSize <size>             The amount of chunk rings to generate around the chunk at the origin.
+	//     ticks <amount>               The amount of simulation ticks to run.
+	//     deltaTime <seconds>          The amount of simulated seconds per tick.
+	//     reportInterval <ticks>       The amount of ticks between two progress reports (0 disables reports).
+	//     drone <x> <z>                Spawns a drone at the given position.
+	//     build <buildingType> <x> <z> Enqueues the construction of a building on the nearest suitable cell.
+	//     focus <x> <z>                Simulates buildings far away from this position in coarse steps, as if the camera
+	//                                  was located there (everything is simulated at full rate if omitted).
+	//     worlds <amount>              The amount of copies of the world which are simulated concurrently, each on its own
+	//                                  thread and with its own registry.
+	struct Scenario
+	{
+		size_t seed{ 256 };
+		int worldSize{ 4 };
+		size_t ticks{ 10000 };
+		double deltaTime{ 1.0 / 60.0 };
+		size_t reportInterval{ 1000 };
+		std::vector<glm::vec2> drones;
+		std::vector<ScenarioBuilding> buildings;
+		bool hasFocus{ false };
+		glm::vec2 focus;
+		size_t worlds{ 1 };
+
+		static Scenario load(const std::string& fileName);
+	};
+}
@@ -0,0 +1,49 @@
+#include "BufferTexture.hpp"
+
+namespace rendering
+{
+	namespace model
+	{
+		BufferTexture::BufferTexture(GLenum internalFormat, const void* data, size_t size)
+		{
+#ifdef LEAVING_HOME_HEADLESS
+			buffer = 0;
+			texture = 0;
+#else
+			glGenBuffers(1, &buffer);
+			glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+			glBufferData(GL_TEXTURE_BUFFER, size, data, GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_BUFFER, texture);
+			glTexBuffer(GL_TEXTURE_BUFFER, internalFormat, buffer);
+			glBindTexture(GL_TEXTURE_BUFFER, 0);
+#endif
+		}
+
+		BufferTexture::~BufferTexture()
+		{
+#ifndef LEAVING_HOME_HEADLESS
+			glDeleteTextures(1, &texture);
+			glDeleteBuffers(1, &buffer);
+#endif
+		}
+
+		void BufferTexture::setSubData(size_t offset, const void* data, size_t size)
+		{
+#ifndef LEAVING_HOME_HEADLESS
+			glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+			glBufferSubData(GL_TEXTURE_BUFFER, offset, size, data);
+			glBindBuffer(GL_TEXTURE_BUFFER, 0);
+#endif
+		}
+
+		void BufferTexture::bind(GLuint textureUnit)
+		{
+			glActiveTexture(GL_TEXTURE0 + textureUnit);
+			glBindTexture(GL_TEXTURE_BUFFER, texture);
+			glActiveTexture(GL_TEXTURE0);
+		}
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// Standard headers
+#include <stdlib.h>
+
+// OpenGL related headers
+#include <GL/glew.h>
+
+namespace rendering
+{
+	namespace model
+	{
+		// A buffer whose data can be fetched in shaders through a buffer texture (i.e. a samplerBuffer, isamplerBuffer or
+		// usamplerBuffer), where each texel has the given internal format.
+		class BufferTexture
+		{
+		public:
+			BufferTexture(GLenum internalFormat, const void* data, size_t size);
+
+			~BufferTexture();
+
+			// Overwrites the given range of bytes of the buffer. The range must lie within the size the buffer was
+			// created with.
+			void setSubData(size_t offset, const void* data, size_t size);
+
+			void bind(GLuint textureUnit);
+
+		private:
+			GLuint buffer;
+			GLuint texture;
+		};
+	}
+}
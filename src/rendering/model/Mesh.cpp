@@ -1,5 +1,7 @@
 #include "Mesh.hpp"
 
+#include <atomic>
+
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "../../../lib/tinyobjloader/tiny_obj_loader.h"
 
@@ -254,6 +256,13 @@ namespace rendering
 			const std::unordered_map<GLuint, std::shared_ptr<IVertexAttribute>> additionalVertexAttributes
 		)
 		{
+#ifdef LEAVING_HOME_HEADLESS
+			// There is no OpenGL context when running headless, so no data can be uploaded. Each mesh still gets a unique
+			// (fake) VAO name so that meshes can be told apart when being used as keys. Meshes may be created by worlds
+			// running on different threads.
+			static std::atomic<GLuint> nextHeadlessVao{ 1 };
+			vao = nextHeadlessVao++;
+#else
 			// Create a Vertex Array Object (VAO).
 			glGenVertexArrays(1, &vao);
 			glBindVertexArray(vao);
@@ -314,6 +323,7 @@ namespace rendering
 
 			// Unbind the VAO to ensure that it won't be changed by any other piece of code by accident.
 			glBindVertexArray(0);
+#endif
 
 			// Store that the attribute locations 0 through 13 are in use. Therefore no other vertex buffer can be added
 			// for these locations.
@@ -327,6 +337,7 @@ namespace rendering
 
 		Mesh::~Mesh()
 		{
+#ifndef LEAVING_HOME_HEADLESS
 			glDeleteVertexArrays(1, &vao);
 
 			glDeleteBuffers(1, &vertexVbo);
@@ -339,6 +350,13 @@ namespace rendering
 
 			for (auto& vbo : additionalVbos)
 				glDeleteBuffers(1, &vbo.second);
+
+			if (instanceDataTexture != 0)
+			{
+				glDeleteTextures(1, &instanceDataTexture);
+				glDeleteBuffers(1, &instanceDataBuffer);
+			}
+#endif
 		}
 
 		void Mesh::addAdditionalVertexAttribute(
@@ -352,6 +370,9 @@ namespace rendering
 				throw std::invalid_argument("Location already in use!");
 			usedAttributeLocations.insert(location);
 
+#ifdef LEAVING_HOME_HEADLESS
+			additionalVbos.insert(std::make_pair(location, 0));
+#else
 			// Bind the VAO as we're about to add a new VBO to it.
 			glBindVertexArray(vao);
 
@@ -367,6 +388,7 @@ namespace rendering
 
 			// Unbind the VAO to ensure that it won't be changed by any other piece of code by accident.
 			glBindVertexArray(0);
+#endif
 		}
 
 		void Mesh::setAdditionalVertexAttributeData(
@@ -383,6 +405,7 @@ namespace rendering
 			}
 			else
 			{
+#ifndef LEAVING_HOME_HEADLESS
 				// Bind the VAO as we're about to modify a VBO of it.
 				glBindVertexArray(vao);
 
@@ -392,6 +415,7 @@ namespace rendering
 
 				// Unbind the VAO to ensure that it won't be changed by any other piece of code by accident.
 				glBindVertexArray(0);
+#endif
 			}
 		}
 
@@ -418,6 +442,7 @@ namespace rendering
 
 		void Mesh::setData(const MeshData& data)
 		{
+#ifndef LEAVING_HOME_HEADLESS
 			glBindVertexArray(vao);
 
 			// Update the VBO data (i.e. vertex positions, uv coordinates and normals).
@@ -429,6 +454,7 @@ namespace rendering
 
 			glBindBuffer(GL_ARRAY_BUFFER, normalVbo);
 			glBufferData(GL_ARRAY_BUFFER, data.normals.size() * sizeof(glm::vec3), &data.normals[0], GL_STATIC_DRAW);
+#endif
 
 			// Update the MeshParts (i.e. indices and materials).
 			std::unordered_map<Material, std::shared_ptr<MeshPart>> oldParts;
@@ -450,8 +476,10 @@ namespace rendering
 				}
 			}
 
+#ifndef LEAVING_HOME_HEADLESS
 			// Unbind the VAO to ensure that it won't be changed by any other piece of code by accident.
 			glBindVertexArray(0);
+#endif
 
 			// Add the additional vertex attributes (if needed).
 			for (auto& locationAndAttribute : data.additionalVertexAttributes)
@@ -460,6 +488,73 @@ namespace rendering
 			boundingGeometry->fitToVertices(data.vertices);
 		}
 
+		void Mesh::setInstanceSubData(
+			const void* data,
+			size_t amountOfInstances,
+			size_t firstInstance,
+			size_t amountOfInstancesToWrite,
+			size_t instanceSize
+		) {
+			size_t size = amountOfInstances * instanceSize;
+
+#ifndef LEAVING_HOME_HEADLESS
+			createInstanceDataTexture();
+
+			if (size > instanceDataCapacity)
+			{
+				size_t newCapacity = std::max(size, 2 * instanceDataCapacity);
+				growBuffer(instanceDataBuffer, instanceDataCapacity, newCapacity);
+				instanceDataCapacity = newCapacity;
+			}
+
+			if (amountOfInstancesToWrite > 0)
+			{
+				glBindBuffer(GL_COPY_WRITE_BUFFER, instanceDataBuffer);
+				glBufferSubData(
+					GL_COPY_WRITE_BUFFER,
+					firstInstance * instanceSize,
+					amountOfInstancesToWrite * instanceSize,
+					(const char*)data + firstInstance * instanceSize
+				);
+			}
+#else
+			instanceDataCapacity = std::max(instanceDataCapacity, size);
+#endif
+
+			setAmountOfInstancesPerEntity(amountOfInstances);
+		}
+
+		void Mesh::createInstanceDataTexture()
+		{
+			if (instanceDataTexture != 0)
+				return;
+
+			// Create a buffer texture through which the instance data can be fetched in the shaders.
+			glGenBuffers(1, &instanceDataBuffer);
+			glGenTextures(1, &instanceDataTexture);
+
+			glBindBuffer(GL_TEXTURE_BUFFER, instanceDataBuffer);
+			glBindTexture(GL_TEXTURE_BUFFER, instanceDataTexture);
+			glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, instanceDataBuffer);
+			glBindTexture(GL_TEXTURE_BUFFER, 0);
+		}
+
+		void Mesh::setAmountOfInstancesPerEntity(size_t amountOfInstances)
+		{
+			if (amountOfInstances == amountOfInstancesPerEntity)
+				return;
+			amountOfInstancesPerEntity = amountOfInstances;
+
+#ifndef LEAVING_HOME_HEADLESS
+			// All instances drawn for an entity share the matrices of that entity. A divisor of zero would turn the
+			// matrices into per-vertex attributes, so it must be at least one even if there are no instances.
+			glBindVertexArray(vao);
+			for (GLuint location = 3; location < 14; location++)
+				glVertexAttribDivisor(location, std::max(amountOfInstances, (size_t)1));
+			glBindVertexArray(0);
+#endif
+		}
+
 		void Mesh::render(rendering::shading::Shader& shader)
 		{
 			glBindVertexArray(vao);
@@ -478,6 +573,23 @@ namespace rendering
 
 			glBindVertexArray(vao);
 
+			if (instanceDataTexture != 0)
+			{
+				glActiveTexture(GL_TEXTURE0 + INSTANCE_DATA_TEXTURE_UNIT);
+				glBindTexture(GL_TEXTURE_BUFFER, instanceDataTexture);
+				glActiveTexture(GL_TEXTURE0);
+				shader.setUniformInt("instanceData", INSTANCE_DATA_TEXTURE_UNIT);
+			}
+
+			// The texture unit may still hold the lookup data of the previously rendered mesh, so the shader needs to
+			// know whether the lookup data belongs to this mesh.
+			shader.setUniformInt("hasLookupData", lookupData != nullptr);
+			if (lookupData != nullptr)
+			{
+				lookupData->bind(LOOKUP_DATA_TEXTURE_UNIT);
+				shader.setUniformInt("lookupData", LOOKUP_DATA_TEXTURE_UNIT);
+			}
+
 			if (numInstances > maxInstancesDrawn)
 			{
 				maxInstancesDrawn = numInstances;
@@ -504,7 +616,7 @@ namespace rendering
 			}
 
 			for (auto part : parts)
-				part->renderInstanced(shader, numInstances);
+				part->renderInstanced(shader, numInstances * amountOfInstancesPerEntity);
 
 			glBindVertexArray(0);
 		}
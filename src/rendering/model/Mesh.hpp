@@ -1,6 +1,7 @@
 #pragma once
 
 // Standard headers
+#include <algorithm>
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdexcept>
@@ -16,6 +17,7 @@
 #include <glm/glm.hpp>
 
 // Our headers
+#include "BufferTexture.hpp"
 #include "MeshPart.hpp"
 #include "../bounding_geometry/BoundingGeometry.hpp"
 #include "../bounding_geometry/None.hpp"
@@ -25,6 +27,12 @@ namespace rendering
 {
 	namespace model
 	{
+		// The texture unit to which the instance data of a mesh is bound while rendering the mesh.
+		constexpr GLuint INSTANCE_DATA_TEXTURE_UNIT = 15;
+
+		// The texture unit to which the lookup data of a mesh is bound while rendering the mesh.
+		constexpr GLuint LOOKUP_DATA_TEXTURE_UNIT = 14;
+
 		enum class VertexAttributeType
 		{
 			SINGLE_PRECISION, DOUBLE_PRECISION, INTEGER
@@ -301,6 +309,38 @@ namespace rendering
 
 			void setData(const MeshData& data);
 
+			// Sets the per-instance data of this mesh, but only uploads the given range of instances. Each element of the
+			// given vector describes one instance of this mesh and must consist of one or more vec4 texels. A mesh with
+			// instance data is drawn once per instance for each entity rendering the mesh, where all instances share the
+			// transformation of their entity. The texels of an instance can be fetched from the samplerBuffer instanceData
+			// in the shader starting at the index gl_InstanceID * (sizeof(InstanceType) / sizeof(glm::vec4)), so such a
+			// mesh should only be rendered by a single entity. The instances outside of the given range must not have
+			// changed since they were last uploaded. This allows to update, add or remove single instances (e.g. by moving
+			// the last instance into the slot of the removed one) without uploading all instances again.
+			template <typename InstanceType>
+			void setInstanceSubData(
+				const std::vector<InstanceType>& instances,
+				size_t firstInstance,
+				size_t amountOfInstancesToWrite
+			) {
+				static_assert(sizeof(InstanceType) % sizeof(glm::vec4) == 0, "Instances must consist of whole vec4 texels!");
+				setInstanceSubData(
+					instances.empty() ? nullptr : &instances[0],
+					instances.size(),
+					firstInstance,
+					amountOfInstancesToWrite,
+					sizeof(InstanceType)
+				);
+			}
+
+			// Sets a buffer texture which is bound to the samplerBuffer lookupData while rendering this mesh. Unlike the
+			// instance data, lookup data may be shared by several meshes (e.g. state which is looked up by the vertices'
+			// cell IDs). Shaders are told through the bool uniform hasLookupData whether the mesh has lookup data.
+			void setLookupData(std::shared_ptr<BufferTexture> _lookupData)
+			{
+				lookupData = _lookupData;
+			}
+
 			void render(shading::Shader& shader);
 
 			void renderInstanced(
@@ -345,6 +385,25 @@ namespace rendering
 
 			size_t maxInstancesDrawn;
 
+			GLuint instanceDataBuffer{ 0 };
+			GLuint instanceDataTexture{ 0 };
+			size_t instanceDataCapacity{ 0 };
+			size_t amountOfInstancesPerEntity{ 1 };
+
+			std::shared_ptr<BufferTexture> lookupData{ nullptr };
+
+			void setInstanceSubData(
+				const void* data,
+				size_t amountOfInstances,
+				size_t firstInstance,
+				size_t amountOfInstancesToWrite,
+				size_t instanceSize
+			);
+
+			void createInstanceDataTexture();
+
+			void setAmountOfInstancesPerEntity(size_t amountOfInstances);
+
 			static std::vector<std::shared_ptr<MeshPart>> createMeshParts(const std::vector<std::shared_ptr<MeshPartData>>& parts);
 
 			void initOpenGlBuffers(
@@ -4,17 +4,49 @@ namespace rendering
 {
 	namespace model
 	{
+		void growBuffer(GLuint buffer, GLsizeiptr oldSize, GLsizeiptr newSize)
+		{
+#ifndef LEAVING_HOME_HEADLESS
+			// Resizing a buffer discards its data, so the data to keep is copied into a temporary buffer in between.
+			GLuint temporaryBuffer = 0;
+			if (oldSize > 0)
+			{
+				glGenBuffers(1, &temporaryBuffer);
+				glBindBuffer(GL_COPY_WRITE_BUFFER, temporaryBuffer);
+				glBufferData(GL_COPY_WRITE_BUFFER, oldSize, nullptr, GL_STREAM_COPY);
+				glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize);
+			}
+
+			glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+			glBufferData(GL_COPY_WRITE_BUFFER, newSize, nullptr, GL_DYNAMIC_DRAW);
+
+			if (oldSize > 0)
+			{
+				glBindBuffer(GL_COPY_READ_BUFFER, temporaryBuffer);
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize);
+				glDeleteBuffers(1, &temporaryBuffer);
+			}
+#endif
+		}
+
 		MeshPart::MeshPart(std::shared_ptr<Material> _material, const std::vector<unsigned int>& indices, GLenum _mode)
 			: material(std::move(_material)), numIndices((GLsizei)indices.size()), mode(_mode)
 		{
+#ifdef LEAVING_HOME_HEADLESS
+			indexBuffer = 0;
+#else
 			glGenBuffers(1, &indexBuffer);
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+#endif
 		}
 
 		MeshPart::~MeshPart()
 		{
+#ifndef LEAVING_HOME_HEADLESS
 			glDeleteBuffers(1, &indexBuffer);
+#endif
 		}
 
 		void MeshPart::setData(std::shared_ptr<MeshPartData> data)
@@ -23,8 +55,10 @@ namespace rendering
 			numIndices = data->indices.size();
 			mode = data->mode;
 
+#ifndef LEAVING_HOME_HEADLESS
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
 			glBufferData(GL_ELEMENT_ARRAY_BUFFER, data->indices.size() * sizeof(unsigned int), &data->indices[0], GL_STATIC_DRAW);
+#endif
 		}
 
 		void MeshPart::render(rendering::shading::Shader& shader)
@@ -16,6 +16,10 @@ namespace rendering
 {
 	namespace model
 	{
+		// Grows the given buffer to the given size. The buffer keeps its name and the first oldSize bytes of its data, so
+		// that VAOs referencing the buffer stay valid.
+		void growBuffer(GLuint buffer, GLsizeiptr oldSize, GLsizeiptr newSize);
+
 		struct MeshPartData
 		{
 			std::shared_ptr<Material> material;
@@ -63,10 +63,16 @@ namespace rendering::systems
 	struct Picking
 	{
 		std::unordered_set<model::Mesh*> enabled;
+
+		// Meshes whose vertices are transformed in their shader need a picking shader doing the same transformation.
+		std::unordered_map<model::Mesh*, shading::Shader*> shaders;
 	};
 
 	struct ShadowMapping
 	{
 		std::unordered_map<model::Mesh*, int> castShadow;
+
+		// Meshes whose vertices are transformed in their shader need a shadow shader doing the same transformation.
+		std::unordered_map<model::Mesh*, shading::Shader*> shaders;
 	};
 }
@@ -85,13 +85,41 @@ namespace rendering::systems
 	void renderShadowMap(entt::registry& registry, rendering::components::Camera& camera, shading::Shader* shader)
 	{
 		auto& shadows = registry.ctx<ShadowMapping>();
-		renderSelection(registry, shadows.castShadow, camera, shader);
+		if (shadows.shaders.empty())
+		{
+			renderSelection(registry, shadows.castShadow, camera, shader);
+			return;
+		}
+
+		std::unordered_map<shading::Shader*, std::unordered_set<model::Mesh*>> meshesPerShader;
+		for (const auto& meshAndLevel : shadows.castShadow)
+		{
+			auto found = shadows.shaders.find(meshAndLevel.first);
+			meshesPerShader[found != shadows.shaders.end() ? found->second : shader].insert(meshAndLevel.first);
+		}
+
+		for (auto& shaderAndMeshes : meshesPerShader)
+			renderSelection(registry, shaderAndMeshes.second, camera, shaderAndMeshes.first);
 	}
 
 	void renderPicking(entt::registry& registry, rendering::components::Camera& camera, shading::Shader* pickingShader)
 	{
 		auto& picking = registry.ctx<Picking>();
-		renderSelection(registry, picking.enabled, camera, pickingShader);
+		if (picking.shaders.empty())
+		{
+			renderSelection(registry, picking.enabled, camera, pickingShader);
+			return;
+		}
+
+		std::unordered_map<shading::Shader*, std::unordered_set<model::Mesh*>> meshesPerShader;
+		for (auto* mesh : picking.enabled)
+		{
+			auto found = picking.shaders.find(mesh);
+			meshesPerShader[found != picking.shaders.end() ? found->second : pickingShader].insert(mesh);
+		}
+
+		for (auto& shaderAndMeshes : meshesPerShader)
+			renderSelection(registry, shaderAndMeshes.second, camera, shaderAndMeshes.first);
 	}
 
 	void renderMeshes(entt::registry& registry, rendering::components::Camera& camera, shading::RenderPass filter)
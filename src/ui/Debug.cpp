@@ -3,14 +3,9 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 
-namespace game::systems
-{
-	extern float droneMovementSpeedMultiplier;
-}
-
 namespace gui
 {
-	void renderDebugWindow(game::DayNightCycle& daynight, CameraType* camera)
+	void renderDebugWindow(entt::registry& registry, game::DayNightCycle& daynight, CameraType* camera)
 	{
 		ImGui::Begin("Debug");
 
@@ -56,11 +51,9 @@ namespace gui
 		ImGui::Separator();
 
 		ImGui::Text("Drone Settings");
-		int droneSpeed = (int) game::systems::droneMovementSpeedMultiplier;
+		int droneSpeed = (int) game::systems::getDroneMovementSpeedMultiplier(registry);
 		ImGui::SliderInt("Drone Speed", &droneSpeed, 0, 10, "%dx");
-		game::systems::droneMovementSpeedMultiplier = (float) droneSpeed;
-
-		//std::cout << game::systems::droneMovementSpeedMultiplier << std::endl;
+		game::systems::setDroneMovementSpeedMultiplier(registry, (float) droneSpeed);
 
 
 		ImGui::Separator();
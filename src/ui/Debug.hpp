@@ -20,5 +20,5 @@ namespace gui
 		FREE
 	};
 
-	void renderDebugWindow(game::DayNightCycle& daynight, CameraType* camera);
+	void renderDebugWindow(entt::registry& registry, game::DayNightCycle& daynight, CameraType* camera);
 }
\ No newline at end of file
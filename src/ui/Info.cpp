@@ -67,11 +67,19 @@ namespace gui
 			ImGui::TextUnformatted(cellContent->getInventoryContentsString().c_str());
 
 			auto entity = cellContent->getEntity();
+			auto* residents = registry.try_get<game::systems::Residents>(entity);
+			if (residents != nullptr)
+				ImGui::TextWrapped("Citizens: %u (food supply: %i%%)", residents->amount, (int)(100.0f * residents->foodSupply));
+
+			auto* workplace = registry.try_get<game::systems::Workplace>(entity);
+			if (workplace != nullptr && workplace->jobs > 0)
+				ImGui::TextWrapped("Workers: %u / %u", workplace->workers, workplace->jobs);
+
 			auto* droneFactory = registry.try_get<game::world::DroneFactoryBuildingComponent>(entity);
 			if (droneFactory != nullptr) {
 				ImGui::TextWrapped("Drones to produce: %i", droneFactory->amountOfDronesToProduce);
 				if (ImGui::Button("Produce"))
-					droneFactory->amountOfDronesToProduce++;
+					droneFactory->building->enqueueDroneProduction();
 			}
 		}
 
@@ -11,6 +11,7 @@
 
 #include <entt/entt.hpp>
 
+#include "../game/systems/PopulationSystem.hpp"
 #include "../game/world/World.hpp"
 #include "../game/world/buildings/DroneFactoryBuilding.hpp"
 
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <iterator>
+#include <map>
+
+namespace util
+{
+	// Hands out ranges of elements (e.g. vertices within a vertex buffer) and keeps track of the ranges which were freed, so
+	// that they can be reused by later allocations. Free ranges are chosen first fit and adjacent free ranges are merged.
+	// If no free range is large enough, the range is allocated at the end, i.e. the capacity (the end of the last range
+	// ever allocated) grows. The capacity never shrinks.
+	class RangeAllocator
+	{
+	public:
+		// Returns the offset of a range consisting of the given amount of elements.
+		size_t allocate(size_t size)
+		{
+			if (size == 0)
+				return 0;
+
+			for (auto it = freeRanges.begin(); it != freeRanges.end(); it++)
+			{
+				if (it->second < size)
+					continue;
+
+				size_t offset = it->first;
+				size_t remainingSize = it->second - size;
+				freeRanges.erase(it);
+				if (remainingSize > 0)
+					freeRanges.insert(std::make_pair(offset + size, remainingSize));
+
+				return offset;
+			}
+
+			// A free range at the end can be grown instead of leaving it unused.
+			size_t offset = capacity;
+			if (!freeRanges.empty())
+			{
+				auto last = std::prev(freeRanges.end());
+				if (last->first + last->second == capacity)
+				{
+					offset = last->first;
+					freeRanges.erase(last);
+				}
+			}
+
+			capacity = offset + size;
+			return offset;
+		}
+
+		void free(size_t offset, size_t size)
+		{
+			if (size == 0)
+				return;
+
+			auto next = freeRanges.lower_bound(offset);
+			if (next != freeRanges.end() && offset + size == next->first)
+			{
+				size += next->second;
+				next = freeRanges.erase(next);
+			}
+
+			if (next != freeRanges.begin())
+			{
+				auto previous = std::prev(next);
+				if (previous->first + previous->second == offset)
+				{
+					previous->second += size;
+					return;
+				}
+			}
+
+			freeRanges.insert(std::make_pair(offset, size));
+		}
+
+		size_t getCapacity() const
+		{
+			return capacity;
+		}
+
+	private:
+		// The offset and size of all free ranges below the capacity.
+		std::map<size_t, size_t> freeRanges;
+		size_t capacity{ 0 };
+	};
+}
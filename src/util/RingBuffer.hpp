@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <stdlib.h>
+
+namespace util
+{
+	// A FIFO queue with a fixed capacity. The elements are stored inline, so pushing and popping elements never allocates
+	// any memory.
+	template <typename T, size_t Capacity>
+	class RingBuffer
+	{
+	public:
+		bool empty() const
+		{
+			return count == 0;
+		}
+
+		bool full() const
+		{
+			return count == Capacity;
+		}
+
+		size_t size() const
+		{
+			return count;
+		}
+
+		size_t freeCapacity() const
+		{
+			return Capacity - count;
+		}
+
+		T& front()
+		{
+			return elements[head];
+		}
+
+		T& back()
+		{
+			return elements[(head + count - 1) % Capacity];
+		}
+
+		T& operator[](size_t index)
+		{
+			return elements[(head + index) % Capacity];
+		}
+
+		// Appends the given element. Returns false (and leaves the buffer untouched) if the buffer is full.
+		bool push(const T& element)
+		{
+			if (full())
+				return false;
+
+			elements[(head + count) % Capacity] = element;
+			count++;
+			return true;
+		}
+
+		void pop()
+		{
+			// Reset the removed element so that it doesn't keep any resources alive.
+			elements[head] = T();
+			head = (head + 1) % Capacity;
+			count--;
+		}
+
+		void clear()
+		{
+			while (!empty())
+				pop();
+		}
+
+	private:
+		std::array<T, Capacity> elements;
+		size_t head{ 0 };
+		size_t count{ 0 };
+	};
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "MathUtil.hpp"
+
+namespace util
+{
+	// A uniform grid over a plane whose cells are hashed into a power of two amount of buckets. The hash is meant to be
+	// rebuilt from scratch whenever the items have moved: The bucket of each item can be computed in parallel, and the
+	// items are then sorted into their buckets by a counting sort in linear time. Once the buffers have grown to the amount
+	// of items, rebuilding the hash doesn't allocate any memory.
+	// Items of different cells may share the same bucket, so queries must check the actual distance to the items they are
+	// given.
+	class SpatialHash
+	{
+	public:
+		SpatialHash(float _cellSize) : cellSize(_cellSize) {}
+
+		// Prepares the hash for the given amount of items. Must be called before computing the buckets of the items.
+		void resize(size_t amountOfItems)
+		{
+			size_t amountOfBuckets = 1;
+			while (amountOfBuckets < 2 * amountOfItems)
+				amountOfBuckets <<= 1;
+
+			bucketMask = (uint32_t) (amountOfBuckets - 1);
+			bucketEnds.resize(amountOfBuckets);
+			items.resize(amountOfItems);
+		}
+
+		uint32_t getBucket(glm::vec2 position) const
+		{
+			return getBucket(fastFloor(position.x / cellSize), fastFloor(position.y / cellSize));
+		}
+
+		// Sorts the items into their buckets. The i-th element of itemBuckets is the bucket of the item with index i.
+		void build(const std::vector<uint32_t>& itemBuckets)
+		{
+			// Count the items of each bucket and turn the counts into the index at which each bucket starts.
+			std::fill(bucketEnds.begin(), bucketEnds.end(), 0);
+			for (uint32_t bucket : itemBuckets)
+				bucketEnds[bucket]++;
+
+			uint32_t start = 0;
+			for (uint32_t& bucketEnd : bucketEnds)
+			{
+				uint32_t amountOfItemsInBucket = bucketEnd;
+				bucketEnd = start;
+				start += amountOfItemsInBucket;
+			}
+
+			// Placing the items advances the start of each bucket to its end.
+			for (uint32_t item = 0; item < itemBuckets.size(); item++)
+				items[bucketEnds[itemBuckets[item]]++] = item;
+		}
+
+		// Calls func(uint32_t item) for each item in the cell containing the given position and its eight neighbouring cells
+		// (i.e. at least all items within a distance of one cell size). Each item is visited at most once.
+		template <class Func>
+		void forEachItemNear(glm::vec2 position, Func func) const
+		{
+			long cellX = fastFloor(position.x / cellSize);
+			long cellY = fastFloor(position.y / cellSize);
+
+			std::array<uint32_t, 9> buckets;
+			size_t amountOfBuckets = 0;
+			for (long x = cellX - 1; x <= cellX + 1; x++)
+			{
+				for (long y = cellY - 1; y <= cellY + 1; y++)
+				{
+					// Neighbouring cells may be hashed into the same bucket, which must not be visited twice.
+					uint32_t bucket = getBucket(x, y);
+					if (std::find(buckets.begin(), buckets.begin() + amountOfBuckets, bucket) != buckets.begin() + amountOfBuckets)
+						continue;
+
+					buckets[amountOfBuckets++] = bucket;
+					for (uint32_t i = bucket == 0 ? 0 : bucketEnds[bucket - 1]; i < bucketEnds[bucket]; i++)
+						func(items[i]);
+				}
+			}
+		}
+
+	private:
+		float cellSize;
+		uint32_t bucketMask{ 0 };
+
+		// The items of bucket b are stored at the indices [bucketEnds[b - 1], bucketEnds[b]) of items.
+		std::vector<uint32_t> bucketEnds;
+		std::vector<uint32_t> items;
+
+		uint32_t getBucket(long cellX, long cellY) const
+		{
+			return ((uint32_t) cellX * 73856093u ^ (uint32_t) cellY * 19349663u) & bucketMask;
+		}
+	};
+}